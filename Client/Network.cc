@@ -7,8 +7,20 @@
 #include <Shared/Binary.hh>
 #include <Shared/Config.hh>
 
+#include <vector>
+
 using namespace Game;
 
+#ifdef ORBIT_PREDICTION
+//orbiting petals stepped at the end of the last update, shown once the next one
+//arrives unless it corrects them, see Shared/Orbit.hh
+static std::vector<EntityID> predicted_petals;
+#endif
+#ifdef DEAD_RECKONING
+//mobs extrapolated at the end of the last update, the same way, see Shared/Reckoning.hh
+static std::vector<EntityID> reckoned_mobs;
+#endif
+
 void Game::on_message(uint8_t *ptr, uint32_t len) {
     Reader reader(ptr);
     switch(reader.read<uint8_t>()) {
@@ -18,6 +30,16 @@ void Game::on_message(uint8_t *ptr, uint32_t len) {
             simulation_ready = 1;
             is_outdated = reader.read<uint8_t>();
             camera_id = reader.read<EntityID>();
+            #ifdef ORBIT_PREDICTION
+            for (EntityID const &id : predicted_petals)
+                if (simulation.ent_exists(id)) simulation.get_ent(id).apply_orbit_prediction();
+            predicted_petals.clear();
+            #endif
+            #ifdef DEAD_RECKONING
+            for (EntityID const &id : reckoned_mobs)
+                if (simulation.ent_exists(id)) simulation.get_ent(id).apply_reckoning();
+            reckoned_mobs.clear();
+            #endif
             EntityID curr_id = reader.read<EntityID>();
             while(!(curr_id == NULL_ENTITY)) {
                 assert(simulation.ent_exists(curr_id));
@@ -33,8 +55,29 @@ void Game::on_message(uint8_t *ptr, uint32_t len) {
                 Entity &ent = simulation.get_ent(curr_id);
                 ent.read(&reader, BitMath::at(create, 0));
                 if (BitMath::at(create, 1)) ent.pending_delete = 1;
+                #ifdef ORBIT_PREDICTION
+                if (ent.has_component(kPetal) && BitMath::at(ent.get_petal_flags(), PetalFlags::kOrbiting))
+                    predicted_petals.push_back(curr_id);
+                #endif
+                #ifdef DEAD_RECKONING
+                if (ent.has_component(kMob) && !ent.has_component(kSegmented) && !ent.pending_delete) {
+                    ent.reckon();
+                    reckoned_mobs.push_back(curr_id);
+                }
+                #endif
                 curr_id = reader.read<EntityID>();
             }
+            #ifdef ORBIT_PREDICTION
+            //after the whole update, so every flower is up to date
+            std::erase_if(predicted_petals, [](EntityID const &id){
+                Entity &petal = simulation.get_ent(id);
+                if (petal.pending_delete || !simulation.ent_exists(petal.get_parent())) return true;
+                Entity const &flower = simulation.get_ent(petal.get_parent());
+                if (!flower.has_component(kFlower)) return true;
+                petal.predict_orbit(flower);
+                return false;
+            });
+            #endif
             simulation.arena_info.read(&reader, !seen_arena);
             break;
         }
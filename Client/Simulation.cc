@@ -5,6 +5,9 @@
 
 #include <Client/Ui/Extern.hh>
 
+#include <Shared/Orbit.hh>
+#include <Shared/Reckoning.hh>
+
 #include <cmath>
 #include <iostream>
 
@@ -88,6 +91,46 @@ void Entity::tick_lerp(float amt) {
     }
 }
 
+#ifdef ORBIT_PREDICTION
+void Entity::predict_orbit(Entity const &flower) {
+    Vector pos(x.anchor(), y.anchor());
+    Vector vel(orbit_vx, orbit_vy);
+    float next_angle = angle.anchor();
+    orbit_predict(flower, *this, pos, vel, next_angle);
+    orbit_vx = vel.x;
+    orbit_vy = vel.y;
+    predicted_x = pos.x;
+    predicted_y = pos.y;
+    predicted_angle = next_angle;
+}
+
+void Entity::apply_orbit_prediction() {
+    x.set(predicted_x);
+    y.set(predicted_y);
+    angle.set(predicted_angle);
+}
+#endif
+
+#ifdef DEAD_RECKONING
+void Entity::reckon() {
+    Vector pos(x.anchor(), y.anchor());
+    Vector vel(motion_vx, motion_vy);
+    Vector accel(motion_ax, motion_ay);
+    reckon_step(*this, pos, vel, accel, Vector(motion_jx, motion_jy));
+    motion_vx = vel.x;
+    motion_vy = vel.y;
+    motion_ax = accel.x;
+    motion_ay = accel.y;
+    reckoned_x = pos.x;
+    reckoned_y = pos.y;
+}
+
+void Entity::apply_reckoning() {
+    x.set(reckoned_x);
+    y.set(reckoned_y);
+}
+#endif
+
 void Simulation::on_tick() {
     for_each_entity([](Simulation *sim, Entity &ent) {
         ent.tick_lerp(Ui::lerp_amount);
@@ -4,6 +4,7 @@
 
 #include <Shared/Binary.hh>
 #include <Shared/Config.hh>
+#include <Shared/EntityDef.hh>
 
 #include <cstring>
 #include <iostream>
@@ -19,7 +20,7 @@ extern "C" {
             std::printf("Connected\n");
             Writer w(OUTGOING_PACKET);
             w.write<uint8_t>(Serverbound::kVerify);
-            w.write<uint64_t>(VERSION_HASH);
+            w.write<uint64_t>(PROTOCOL_HASH);
             w.write<uint64_t>(Game::recovery_id);
             w.write<uint8_t>(Game::gamemode);
             Game::socket.ready = 1; //force send
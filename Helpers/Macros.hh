@@ -18,4 +18,10 @@
 #define DEBUG_ONLY(...) __VA_ARGS__
 #else
 #define DEBUG_ONLY(...)
-#endif
\ No newline at end of file
+#endif
+
+#ifdef PROFILER
+#define PROFILE_ONLY(...) __VA_ARGS__
+#else
+#define PROFILE_ONLY(...)
+#endif
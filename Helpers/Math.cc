@@ -1,8 +1,11 @@
 #include <Helpers/Math.hh>
 
 #include <cmath>
+#include <cstdlib>
 #include <format>
 
+static thread_local Rng *current_rng = nullptr;
+
 float fclamp(float v, float s, float e) {
     if (!(v >= s)) return s;
     if (!(v <= e)) return e;
@@ -10,7 +13,11 @@ float fclamp(float v, float s, float e) {
 }
 
 double frand() {
-    return std::rand() / ((double) RAND_MAX + 1);
+    if (current_rng == nullptr) {
+        static thread_local Rng fallback(std::rand());
+        return fallback.next_double();
+    }
+    return current_rng->next_double();
 }
 
 float lerp(float v, float e, float a) {
@@ -88,6 +95,49 @@ float LerpFloat::anchor() const {
     return value;
 }
 
+static inline uint64_t rotl(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+Rng::Rng(uint64_t s) {
+    seed(s);
+}
+
+void Rng::seed(uint64_t s) {
+    //splitmix64 expansion so that nearby seeds give unrelated streams
+    for (uint64_t &x : state) {
+        s += 0x9e3779b97f4a7c15ull;
+        uint64_t z = s;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        x = z ^ (z >> 31);
+    }
+}
+
+uint64_t Rng::next() {
+    uint64_t const result = rotl(state[1] * 5, 7) * 9;
+    uint64_t const t = state[1] << 17;
+    state[2] ^= state[0];
+    state[3] ^= state[1];
+    state[1] ^= state[2];
+    state[0] ^= state[3];
+    state[2] ^= t;
+    state[3] = rotl(state[3], 45);
+    return result;
+}
+
+double Rng::next_double() {
+    return (next() >> 11) * 0x1.0p-53;
+}
+
+RngScope::RngScope(Rng &rng) : prev(current_rng) {
+    current_rng = &rng;
+}
+
+RngScope::~RngScope() {
+    current_rng = prev;
+}
+
 SeedGenerator::SeedGenerator(uint32_t s) : seed(s) {}
 
 float SeedGenerator::next() {
@@ -9,6 +9,13 @@ constexpr double M_PI = 3.14159265358979323846;
 
 constexpr uint32_t div_round_up(uint32_t a, uint32_t b) { return (a + b - 1) / b; }
 
+constexpr uint64_t fnv1a(char const *str) {
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (; *str != 0; ++str) hash = (hash ^ static_cast<uint8_t>(*str)) * 0x100000001b3ull;
+    return hash;
+}
+
+//draws from the generator bound to the current thread
 double frand();
 float fclamp(float, float, float);
 float lerp(float, float, float);
@@ -31,6 +38,24 @@ public:
     float anchor() const;
 };
 
+//xoshiro256**, one per simulation so concurrent games stay reproducible
+class Rng {
+    uint64_t state[4];
+public:
+    Rng(uint64_t = 0);
+    void seed(uint64_t);
+    uint64_t next();
+    double next_double();
+};
+
+//binds an Rng to frand() on this thread for the lifetime of the scope
+class RngScope {
+    Rng *prev;
+public:
+    RngScope(Rng &);
+    ~RngScope();
+};
+
 class SeedGenerator {
     uint32_t seed;
 public:
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+//fixed-size blocks carved out of chunks that are never freed, so addresses stay stable
+//and blocks of one kind sit next to each other; shared between game threads
+template<typename T, uint32_t chunk_size = 64>
+class BlockPool {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<T[]>> chunks;
+    std::vector<T *> free_blocks;
+public:
+    //blocks come back reset to T()
+    T *acquire() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (free_blocks.empty()) {
+            chunks.emplace_back(new T[chunk_size]());
+            for (uint32_t i = chunk_size; i > 0; --i)
+                free_blocks.push_back(&chunks.back()[i - 1]);
+        }
+        T *block = free_blocks.back();
+        free_blocks.pop_back();
+        return block;
+    }
+    void release(T *block) {
+        *block = T();
+        std::lock_guard<std::mutex> lock(mutex);
+        free_blocks.push_back(block);
+    }
+};
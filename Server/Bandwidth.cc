@@ -0,0 +1,150 @@
+#include <Server/Bandwidth.hh>
+
+#ifdef PROFILER
+#include <Shared/Arena.hh>
+#include <Shared/Entity.hh>
+
+#include <algorithm>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+//indices follow the Fields enums of Entity and Arena, which come from the same macros
+static char const *ENTITY_FIELD_NAMES[] = {
+    #define SINGLE(component, name, type) #name,
+    #define MULTIPLE(component, name, type, amt) #name,
+    PERFIELD
+    #undef SINGLE
+    #undef MULTIPLE
+};
+
+static uint8_t const ENTITY_FIELD_COMPONENTS[] = {
+    #define SINGLE(component, name, type) k##component,
+    #define MULTIPLE(component, name, type, amt) k##component,
+    PERFIELD
+    #undef SINGLE
+    #undef MULTIPLE
+};
+
+static char const *COMPONENT_NAMES[] = {
+    #define COMPONENT(name) #name,
+    PERCOMPONENT
+    #undef COMPONENT
+};
+
+static char const *ARENA_FIELD_NAMES[] = {
+    #define SINGLE(name, type) #name,
+    #define MULTIPLE(name, type, amt) #name,
+    FIELDS_Arena
+    #undef SINGLE
+    #undef MULTIPLE
+};
+
+static char const *OVERHEAD_NAMES[] = { "packet_header", "entity_ids", "deletes", "field_header" };
+
+static uint32_t const ENTITY_FIELD_COUNT = sizeof(ENTITY_FIELD_NAMES) / sizeof(ENTITY_FIELD_NAMES[0]);
+static uint32_t const ARENA_FIELD_COUNT = sizeof(ARENA_FIELD_NAMES) / sizeof(ARENA_FIELD_NAMES[0]);
+
+struct FieldCounter {
+    //indexed by create
+    uint64_t bytes[2];
+    uint64_t writes[2];
+};
+
+//each game thread counts into its own table, tables are read
+//between ticks when every game thread is parked
+struct Counters {
+    FieldCounter entity[ENTITY_FIELD_COUNT];
+    FieldCounter arena[ARENA_FIELD_COUNT];
+    FieldCounter overhead[Bandwidth::kOverheadCount];
+};
+
+static std::mutex registry_mutex;
+static std::vector<Counters *> registry;
+static thread_local Counters *local = nullptr;
+
+static Counters &_local() {
+    if (local == nullptr) {
+        local = new Counters{};
+        std::lock_guard<std::mutex> lock(registry_mutex);
+        registry.push_back(local);
+    }
+    return *local;
+}
+
+static void _add(FieldCounter &counter, uint8_t create, uint32_t bytes) {
+    counter.bytes[create != 0] += bytes;
+    ++counter.writes[create != 0];
+}
+
+void Bandwidth::record_entity(uint32_t field, uint8_t create, uint32_t bytes) {
+    _add(_local().entity[field], create, bytes);
+}
+
+void Bandwidth::record_arena(uint32_t field, uint8_t create, uint32_t bytes) {
+    _add(_local().arena[field], create, bytes);
+}
+
+void Bandwidth::record_overhead(uint32_t kind, uint8_t create, uint32_t bytes) {
+    _add(_local().overhead[kind], create, bytes);
+}
+
+struct ReportLine {
+    std::string name;
+    FieldCounter counter;
+};
+
+static void _merge(FieldCounter &into, FieldCounter const &from) {
+    for (uint32_t i = 0; i < 2; ++i) {
+        into.bytes[i] += from.bytes[i];
+        into.writes[i] += from.writes[i];
+    }
+}
+
+void Bandwidth::print_report(uint32_t ticks) {
+    if (ticks == 0) return;
+    Counters total{};
+    {
+        std::lock_guard<std::mutex> lock(registry_mutex);
+        for (Counters *counters : registry) {
+            for (uint32_t i = 0; i < ENTITY_FIELD_COUNT; ++i) _merge(total.entity[i], counters->entity[i]);
+            for (uint32_t i = 0; i < ARENA_FIELD_COUNT; ++i) _merge(total.arena[i], counters->arena[i]);
+            for (uint32_t i = 0; i < kOverheadCount; ++i) _merge(total.overhead[i], counters->overhead[i]);
+            *counters = {};
+        }
+    }
+    std::vector<ReportLine> fields;
+    std::vector<ReportLine> components(kComponentCount);
+    for (uint32_t i = 0; i < kComponentCount; ++i) components[i].name = COMPONENT_NAMES[i];
+    for (uint32_t i = 0; i < ENTITY_FIELD_COUNT; ++i) {
+        fields.push_back({ ENTITY_FIELD_NAMES[i], total.entity[i] });
+        _merge(components[ENTITY_FIELD_COMPONENTS[i]].counter, total.entity[i]);
+    }
+    for (uint32_t i = 0; i < ARENA_FIELD_COUNT; ++i)
+        fields.push_back({ std::string("arena.") + ARENA_FIELD_NAMES[i], total.arena[i] });
+    for (uint32_t i = 0; i < kOverheadCount; ++i)
+        fields.push_back({ OVERHEAD_NAMES[i], total.overhead[i] });
+
+    auto bytes_of = [](ReportLine const &line) { return line.counter.bytes[0] + line.counter.bytes[1]; };
+    auto by_bytes = [&](ReportLine const &a, ReportLine const &b) { return bytes_of(a) > bytes_of(b); };
+    std::sort(fields.begin(), fields.end(), by_bytes);
+    std::sort(components.begin(), components.end(), by_bytes);
+    uint64_t all_bytes = 0;
+    for (ReportLine const &line : fields) all_bytes += bytes_of(line);
+
+    auto print = [&](ReportLine const &line) {
+        uint64_t const bytes = bytes_of(line);
+        if (bytes == 0) return;
+        std::cout << "  " << line.name << ": " << (double) bytes / ticks << " B/tick ("
+            << 100.0 * bytes / all_bytes << "%), " << (double) (line.counter.writes[0] + line.counter.writes[1]) / ticks
+            << " writes/tick, " << 100.0 * line.counter.bytes[1] / bytes << "% on create\n";
+    };
+    std::cout << "Replication Bandwidth (" << ticks << " ticks, " << (double) all_bytes / ticks << " B/tick): {\n";
+    std::cout << " Components:\n";
+    for (ReportLine const &line : components) print(line);
+    std::cout << " Fields:\n";
+    for (ReportLine const &line : fields) print(line);
+    std::cout << "}\n";
+}
+#endif
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <Helpers/Macros.hh>
+
+#include <cstdint>
+
+//replication bytes per field, counted with -DPROFILER=1
+//RECORD_BANDWIDTH wraps the writes of one field and attributes the bytes they produced
+#ifdef PROFILER
+namespace Bandwidth {
+    //bytes that belong to no field
+    enum Overhead : uint8_t {
+        kPacketHeader,
+        //entity ids and create flags
+        kEntityIds,
+        kDeletes,
+        //components, lifetime and field list terminators
+        kFieldHeader,
+        kOverheadCount
+    };
+
+    void record_entity(uint32_t, uint8_t, uint32_t);
+    void record_arena(uint32_t, uint8_t, uint32_t);
+    void record_overhead(uint32_t, uint8_t, uint32_t);
+    //prints averages over the given number of ticks, then starts over
+    void print_report(uint32_t);
+}
+
+#define RECORD_BANDWIDTH(kind, field, create, writer, ...) { \
+    uint8_t const *_bandwidth_start = (writer)->at; \
+    __VA_ARGS__ \
+    Bandwidth::record_##kind(field, create, (writer)->at - _bandwidth_start); \
+}
+#else
+#define RECORD_BANDWIDTH(kind, field, create, writer, ...) { __VA_ARGS__ }
+#endif
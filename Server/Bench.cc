@@ -0,0 +1,294 @@
+#include <Server/Bandwidth.hh>
+#include <Server/Client.hh>
+#include <Server/Game.hh>
+#include <Server/Headless.hh>
+#include <Server/Log.hh>
+#include <Server/PetalTracker.hh>
+#include <Server/Profiler.hh>
+#include <Server/Scheduler.hh>
+#include <Server/Server.hh>
+#include <Server/Snapshot.hh>
+
+#include <Shared/Binary.hh>
+#include <Shared/Config.hh>
+#include <Shared/Entity.hh>
+#include <Shared/Map.hh>
+#include <Shared/Simulation.hh>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+//synthetic load driven through Client::on_message over the headless transport
+//usage: gardn-bench [--players N] [--ticks K] [--gamemode ffa|tdm|both] [--cluster F] [--seed S] [--reconnect 0|1] [--snapshot 0|1] [--petal ID] [--hold T] [--leader L]
+//--cluster is the fraction of bots that converge on one hotspot instead of wandering
+//--reconnect drops every bot after the run and times them all recovering their session, like a deploy drain
+//--snapshot times a full snapshot and loads each game back into a fresh simulation, which must save to the same bytes
+//--petal fills every bot's loadout with one PetalID, for loads heavy on a single petal's behavior
+//--hold is how many ticks a bot keeps attacking, defending or idling before picking again
+//--leader keeps the first bot at level L or above, so the leader curse is always running
+
+struct BenchConfig {
+    uint32_t players = 100;
+    uint32_t ticks = 1000;
+    int gamemode = -1;
+    float cluster = 0;
+    uint32_t seed = 1;
+    bool reconnect = false;
+    bool snapshot = false;
+    PetalID::T petal = PetalID::kNone;
+    uint32_t hold = 1;
+    uint32_t leader = 0;
+};
+
+struct Bot {
+    WebSocket *ws;
+    uint8_t gamemode;
+    bool clustered;
+    float target_x;
+    float target_y;
+    uint8_t input = 0;
+    uint32_t input_ticks = 0;
+    bool leader = false;
+};
+
+static uint8_t PACKET[1024];
+
+static void _send(Bot &bot, Writer &writer) {
+    Headless::message(bot.ws, std::string_view(reinterpret_cast<char const *>(writer.packet), writer.at - writer.packet));
+}
+
+static bool _parse_args(int argc, char **argv, BenchConfig &config) {
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string const arg = argv[i];
+        char const *value = argv[i + 1];
+        if (arg == "--players") config.players = std::atoi(value);
+        else if (arg == "--ticks") config.ticks = std::atoi(value);
+        else if (arg == "--cluster") config.cluster = fclamp(std::atof(value), 0, 1);
+        else if (arg == "--seed") config.seed = std::atoi(value);
+        else if (arg == "--reconnect") config.reconnect = std::atoi(value) != 0;
+        else if (arg == "--snapshot") config.snapshot = std::atoi(value) != 0;
+        else if (arg == "--petal") {
+            config.petal = std::atoi(value);
+            if (config.petal >= PetalID::kNumPetals) return false;
+        }
+        else if (arg == "--hold") config.hold = std::max(1, std::atoi(value));
+        else if (arg == "--leader") config.leader = std::min<uint32_t>(std::atoi(value), MAX_LEVEL);
+        else if (arg == "--gamemode") {
+            if (std::strcmp(value, "ffa") == 0) config.gamemode = Gamemode::kFFA;
+            else if (std::strcmp(value, "tdm") == 0) config.gamemode = Gamemode::kTDM;
+            else if (std::strcmp(value, "both") == 0) config.gamemode = -1;
+            else return false;
+        }
+        else return false;
+    }
+    return argc % 2 == 1 && config.ticks > 0;
+}
+
+static void _verify(Bot &bot, uint64_t recovery_id) {
+    Writer writer(PACKET);
+    writer.write<uint8_t>(Serverbound::kVerify);
+    writer.write<uint64_t>(PROTOCOL_HASH);
+    writer.write<uint64_t>(recovery_id);
+    writer.write<uint8_t>(bot.gamemode);
+    _send(bot, writer);
+}
+
+//returns the number of bots that got their old camera back
+static uint32_t _reconnect_all(std::vector<Bot> &bots) {
+    std::vector<EntityID> cameras;
+    std::vector<uint64_t> recovery_ids;
+    for (Bot &bot : bots) {
+        Client *client = bot.ws->getUserData();
+        cameras.push_back(client->camera);
+        recovery_ids.push_back(client->game->simulation.get_ent(client->camera).get_recovery_id());
+        Headless::disconnect(bot.ws, 1001);
+    }
+    uint32_t recovered = 0;
+    for (uint32_t i = 0; i < bots.size(); ++i) {
+        bots[i].ws = Headless::connect();
+        _verify(bots[i], recovery_ids[i]);
+        recovered += bots[i].ws->getUserData()->camera == cameras[i];
+    }
+    return recovered;
+}
+
+//returns the number of games whose state survived a save and load unchanged
+static uint32_t _snapshot_round_trip(double &load_time) {
+    uint32_t matching = 0;
+    for (GameInstance &game : Server::games) {
+        std::vector<uint8_t> saved;
+        Snapshot::Writer writer(saved);
+        game.simulation.save(writer);
+        std::unique_ptr<Simulation> restored = std::make_unique<Simulation>();
+        Snapshot::Reader reader(saved.data(), saved.size());
+        auto start = std::chrono::steady_clock::now();
+        if (!restored->load(reader)) continue;
+        std::chrono::duration<double, std::milli> time = std::chrono::steady_clock::now() - start;
+        load_time += time.count();
+        std::vector<uint8_t> resaved;
+        Snapshot::Writer rewriter(resaved);
+        restored->save(rewriter);
+        matching += resaved == saved
+            && restored->recovery_ids == game.simulation.recovery_ids
+            && restored->camera_count.load() == game.simulation.camera_count.load();
+    }
+    return matching;
+}
+
+//swapped in through the petal tracker, like a drop picked up
+static void _give_petal(Simulation *sim, Entity &player, PetalID::T id) {
+    for (uint32_t i = 0; i < player.get_loadout_count(); ++i) {
+        if (player.get_loadout_ids(i) == id) continue;
+        PetalTracker::remove_petal(sim, player.get_loadout_ids(i));
+        PetalTracker::add_petal(sim, id);
+        player.set_loadout_ids(i, id);
+    }
+}
+
+static void _tick_bot(Bot &bot, Rng &rng, BenchConfig const &config) {
+    Client *client = bot.ws->getUserData();
+    Writer writer(PACKET);
+    if (!client->alive()) {
+        writer.write<uint8_t>(Serverbound::kClientSpawn);
+        writer.write<std::string>("bench");
+        writer.write<std::string>("");
+        return _send(bot, writer);
+    }
+    Simulation *sim = &client->game->simulation;
+    Entity &player = sim->get_ent(sim->get_ent(client->camera).get_player());
+    if (bot.leader && player.get_score() < level_to_score(config.leader))
+        player.set_score(level_to_score(config.leader));
+    if (config.petal != PetalID::kNone) _give_petal(sim, player, config.petal);
+    else if (rng.next_double() < 0.01) {
+        writer.write<uint8_t>(Serverbound::kPetalSwap);
+        writer.write<uint8_t>(rng.next() % MAX_SLOT_COUNT);
+        writer.write<uint8_t>(MAX_SLOT_COUNT + rng.next() % MAX_SLOT_COUNT);
+        _send(bot, writer);
+        writer = Writer(PACKET);
+    }
+    float dx = bot.target_x - player.get_x();
+    float dy = bot.target_y - player.get_y();
+    if (!bot.clustered && (rng.next_double() < 0.005 || dx * dx + dy * dy < 200 * 200)) {
+        bot.target_x = rng.next_double() * ARENA_WIDTH;
+        bot.target_y = rng.next_double() * ARENA_HEIGHT;
+    }
+    writer.write<uint8_t>(Serverbound::kClientInput);
+    writer.write<float>(dx);
+    writer.write<float>(dy);
+    //alternate between attacking, defending and idling
+    if (bot.input_ticks == 0) {
+        bot.input = rng.next() % 3;
+        bot.input_ticks = config.hold;
+    }
+    --bot.input_ticks;
+    writer.write<uint8_t>(bot.input);
+    writer.write<uint8_t>(0);
+    _send(bot, writer);
+}
+
+int main(int argc, char **argv) {
+    BenchConfig config;
+    if (!_parse_args(argc, argv, config)) {
+        std::cout << "usage: " << argv[0] << " [--players N] [--ticks K] [--gamemode ffa|tdm|both] [--cluster F] [--seed S] [--reconnect 0|1] [--snapshot 0|1] [--petal ID] [--hold T] [--leader L]\n";
+        return 1;
+    }
+    std::srand(config.seed);
+    Server::init();
+    Rng rng(config.seed);
+    ZoneDefinition const &hotspot = MAP_DATA[0];
+
+    std::vector<Bot> bots;
+    for (uint32_t i = 0; i < config.players; ++i) {
+        Bot bot;
+        bot.ws = Headless::connect();
+        bot.gamemode = config.gamemode < 0 ? i % Gamemode::kNumGamemodes : config.gamemode;
+        bot.clustered = rng.next_double() < config.cluster;
+        bot.leader = i == 0 && config.leader > 0;
+        if (bot.clustered) {
+            bot.target_x = (hotspot.left + hotspot.right) / 2;
+            bot.target_y = (hotspot.top + hotspot.bottom) / 2;
+        } else {
+            bot.target_x = rng.next_double() * ARENA_WIDTH;
+            bot.target_y = rng.next_double() * ARENA_HEIGHT;
+        }
+        _verify(bot, rng.next());
+        bots.push_back(bot);
+    }
+
+    std::vector<double> tick_times;
+    for (uint32_t i = 0; i < config.ticks; ++i) {
+        for (Bot &bot : bots) _tick_bot(bot, rng, config);
+        auto start = std::chrono::steady_clock::now();
+        Server::tick();
+        std::chrono::duration<double, std::milli> tick_time = std::chrono::steady_clock::now() - start;
+        tick_times.push_back(tick_time.count());
+    }
+
+    uint64_t const bytes_sent = Headless::get_bytes_sent();
+    size_t snapshot_size = 0;
+    double snapshot_time = 0;
+    double snapshot_load_time = 0;
+    uint32_t snapshot_matching = 0;
+    if (config.snapshot) {
+        //the server reuses its buffers, so time a warm one
+        std::vector<uint8_t> buffer;
+        Snapshot::save(buffer);
+        buffer.clear();
+        auto start = std::chrono::steady_clock::now();
+        Snapshot::save(buffer);
+        std::chrono::duration<double, std::milli> save_time = std::chrono::steady_clock::now() - start;
+        snapshot_size = buffer.size();
+        snapshot_time = save_time.count();
+        snapshot_matching = _snapshot_round_trip(snapshot_load_time);
+    }
+    uint32_t recovered = 0;
+    double reconnect_time = 0;
+    if (config.reconnect) {
+        auto start = std::chrono::steady_clock::now();
+        recovered = _reconnect_all(bots);
+        std::chrono::duration<double, std::milli> storm_time = std::chrono::steady_clock::now() - start;
+        reconnect_time = storm_time.count();
+        Server::tick();
+    }
+
+    Log::flush();
+    double total = 0;
+    for (double t : tick_times) total += t;
+    std::sort(tick_times.begin(), tick_times.end());
+    auto percentile = [&](double p) { return tick_times[(tick_times.size() - 1) * p]; };
+    double const bytes_per_client = bots.empty() ? 0 : (double) bytes_sent / bots.size() / tick_times.size();
+    std::cout << "Bench: {\n";
+    std::cout << "  Players: " << config.players << '\n';
+    std::cout << "  Cluster: " << config.cluster << '\n';
+    std::cout << "  Ticks: " << tick_times.size() << '\n';
+    std::cout << "  Mean: " << total / tick_times.size() << "ms\n";
+    std::cout << "  p50: " << percentile(0.5) << "ms\n";
+    std::cout << "  p90: " << percentile(0.9) << "ms\n";
+    std::cout << "  p99: " << percentile(0.99) << "ms\n";
+    std::cout << "  Max: " << tick_times.back() << "ms\n";
+    std::cout << "  Bytes/Client/Tick: " << bytes_per_client << '\n';
+    std::cout << "  Bytes/Client/Second: " << bytes_per_client * TPS << '\n';
+    if (config.reconnect) {
+        std::cout << "  Reconnect Storm: " << reconnect_time << "ms\n";
+        std::cout << "  Sessions Recovered: " << recovered << '/' << bots.size() << '\n';
+    }
+    if (config.snapshot) {
+        std::cout << "  Snapshot Size: " << snapshot_size << '\n';
+        std::cout << "  Snapshot Save: " << snapshot_time << "ms\n";
+        std::cout << "  Snapshot Load: " << snapshot_load_time << "ms\n";
+        std::cout << "  Snapshot Round Trip: " << snapshot_matching << '/' << Server::games.size() << '\n';
+    }
+    std::cout << "}\n";
+    TICK_SCHEDULER.print_graph();
+    for (GameInstance &game : Server::games)
+        TICK_SCHEDULER.print_timings(game.simulation.system_timings, game.get_name());
+    PROFILE_ONLY(Profiler::print_histograms();)
+    PROFILE_ONLY(Bandwidth::print_report(tick_times.size());)
+    return 0;
+}
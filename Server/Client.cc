@@ -2,6 +2,8 @@
 
 #include <Server/EntityFunctions.hh>
 #include <Server/Game.hh>
+#include <Server/Journal.hh>
+#include <Server/Log.hh>
 #include <Server/PetalTracker.hh>
 #include <Server/Server.hh>
 #include <Server/Spawn.hh>
@@ -12,7 +14,6 @@
 #include <Shared/Config.hh>
 
 #include <array>
-#include <iostream>
 
 Client::Client() : game(nullptr) {}
 
@@ -20,14 +21,15 @@ void Client::init(uint64_t recovery_id, uint8_t gamemode) {
     DEBUG_ONLY(assert(game == nullptr);)
     DEBUG_ONLY(recovery_id = 0;)
     EntityID camera_id = NULL_ENTITY;
+    //runs on the socket thread between ticks, so the games' maps are not changing
     for (GameInstance &game : Server::games) {
-        game.simulation.for_each<kCamera>([&](Simulation *sim, Entity &ent){
-            if (ent.get_recovery_id() == recovery_id) {
-                assert(camera_id == NULL_ENTITY);
-                camera_id = ent.id;
-                gamemode = game.gamemode;
-            }
-        });
+        auto iter = game.simulation.recovery_ids.find(recovery_id);
+        if (iter == game.simulation.recovery_ids.end()) continue;
+        //for_each<kCamera> skipped cameras pending deletion
+        if (!game.simulation.ent_alive(iter->second)) continue;
+        DEBUG_ONLY(assert(camera_id == NULL_ENTITY);)
+        camera_id = iter->second;
+        gamemode = game.gamemode;
     }
     if (camera_id == NULL_ENTITY && Server::is_draining) {
         disconnect(CloseReason::kOutdated, "Outdated Version");
@@ -44,9 +46,9 @@ void Client::move(GameInstance *new_game) {
     Entity &new_camera = game->simulation.get_ent(camera);
     new_camera.set_respawn_level(old_camera.get_respawn_level());
     for (uint32_t i = 0; i < 2 * MAX_SLOT_COUNT; ++i) {
-        PetalTracker::remove_petal(new_camera.get_inventory(i));
+        PetalTracker::remove_petal(&game->simulation, new_camera.get_inventory(i));
         new_camera.set_inventory(i, old_camera.get_inventory(i));
-        PetalTracker::add_petal(new_camera.get_inventory(i));
+        PetalTracker::add_petal(&game->simulation, new_camera.get_inventory(i));
     }
     in_view.clear();
     seen_arena = 0;
@@ -80,6 +82,7 @@ void Client::on_message(WebSocket *ws, std::string_view message, uint64_t code)
         ws->end(CloseReason::kServer, "Server Error");
         return;
     }
+    Journal::record_message(client, message);
     if (!client->verified) {
         if (client->check_invalid(
             validator.validate_uint8() &&
@@ -89,7 +92,7 @@ void Client::on_message(WebSocket *ws, std::string_view message, uint64_t code)
             client->disconnect();
             return;
         }
-        if (reader.read<uint64_t>() != VERSION_HASH) {
+        if (reader.read<uint64_t>() != PROTOCOL_HASH) {
             client->disconnect(CloseReason::kOutdated, "Outdated Version");
             return;
         }
@@ -109,6 +112,7 @@ void Client::on_message(WebSocket *ws, std::string_view message, uint64_t code)
         return;
     }
     if (client->check_invalid(validator.validate_uint8())) return;
+    RngScope rng_scope(client->game->simulation.rng);
     switch (reader.read<uint8_t>()) {
         case Serverbound::kVerify:
             client->disconnect();
@@ -157,8 +161,8 @@ void Client::on_message(WebSocket *ws, std::string_view message, uint64_t code)
             uint8_t dev = pwd == "ez hax"; // feel free to use
             camera.set_dev(dev);
             player.set_dev(dev);
-            std::cout << "player_spawn" << (dev ? "_dev " : " ") << name_or_unnamed(name)
-                << " <" << +client->game->gamemode << "," << +player.id.hash << "," << +player.id.id << ">\n";
+            Log::write(dev ? Log::kDevSpawn : Log::kSpawn,
+                { .game = client->game->get_name(), .entity = player.id, .name = name_or_unnamed(name) });
             break;
         }
         case Serverbound::kPetalDelete: {
@@ -204,7 +208,8 @@ void Client::on_message(WebSocket *ws, std::string_view message, uint64_t code)
             Entity &player = simulation->get_ent(camera.get_player());
             if (player.chat_sent != NULL_ENTITY) break;
             player.chat_sent = alloc_chat(simulation, text, player).id;
-            std::cout << "chat " << name_or_unnamed(player.get_name()) << ": " << text << '\n';
+            Log::write(Log::kChat, { .game = client->game->get_name(), .entity = player.id,
+                .name = name_or_unnamed(player.get_name()), .text = text });
             break;
         }
         case Serverbound::kGamemodeSwitch: {
@@ -219,15 +224,17 @@ void Client::on_message(WebSocket *ws, std::string_view message, uint64_t code)
 }
 
 void Client::on_disconnect(WebSocket *ws, int code, std::string_view message) {
-    std::printf("disconnect: [%d]\n", code);
     Client *client = ws->getUserData();
     if (client == nullptr) return;
+    Log::write(Log::kDisconnect, { .game = client->game == nullptr ? nullptr : client->game->get_name(),
+        .entity = client->camera, .value = static_cast<double>(code) });
+    Journal::record_disconnect(client, code);
     client->remove();
 }
 
 bool Client::check_invalid(bool valid) {
     if (valid) return false;
-    std::cout << "client sent an invalid packet\n";
+    Log::write(Log::kInvalidPacket, { .game = game == nullptr ? nullptr : game->get_name(), .entity = camera });
     //optional
     disconnect();
 
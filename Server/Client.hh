@@ -7,7 +7,7 @@
 #include <set>
 #include <string>
 
-#ifdef WASM_SERVER
+#if defined(WASM_SERVER) || defined(HEADLESS_SERVER)
 class WebSocket;
 #else
 #include <App.h>
@@ -25,6 +25,7 @@ public:
     WebSocket *ws;
     uint8_t verified = 0;
     uint8_t seen_arena = 0;
+    uint32_t journal_id = 0;
     Client();
     void init(uint64_t, uint8_t);
     void move(GameInstance *);
@@ -41,7 +42,7 @@ public:
     static void on_disconnect(WebSocket *, int, std::string_view);
 };
 
-#ifdef WASM_SERVER
+#if defined(WASM_SERVER) || defined(HEADLESS_SERVER)
 class WebSocket {
     int ws_id;
 public:
@@ -28,3 +28,4 @@ void entity_clear_references(Simulation *, Entity &);
 void delete_petal(Simulation *, Entity &, PetalID::T);
 void pickup_drop(Simulation *, Entity &, Entity &);
 game_tick_t get_sponge_period(Simulation *, Entity &);
+LoadoutSummary const &get_loadout_summary(Entity &);
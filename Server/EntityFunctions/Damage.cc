@@ -8,9 +8,10 @@
 
 static bool _yggdrasil_revival_clause(Simulation *sim, Entity &player) {
     if (BitMath::at(player.flags, EntityFlags::kZombie)) return false;
-    for (uint32_t i = 0; i < player.get_loadout_count(); ++i) {
-        LoadoutSlot &slot = player.loadout[i];
-        if (slot.get_petal_id() != PetalID::kYggdrasil) continue;
+    uint16_t const slots = get_loadout_summary(player).yggdrasil_slots;
+    for (uint32_t i = 0; slots != 0 && i < player.get_loadout_count(); ++i) {
+        if (!BitMath::at(slots, i)) continue;
+        LoadoutSlot &slot = player.loadout()[i];
         for (uint32_t j = 0; j < slot.size(); ++j) {
             LoadoutPetal &petal_slot = slot.petals[j];
             if (sim->ent_alive(petal_slot.ent_id)) {
@@ -24,9 +25,10 @@ static bool _yggdrasil_revival_clause(Simulation *sim, Entity &player) {
 
 game_tick_t get_sponge_period(Simulation *sim, Entity &player) {
     if (!player.has_component(kFlower)) return 0;
-    for (uint32_t i = 0; i < player.get_loadout_count(); ++i) {
-        LoadoutSlot &slot = player.loadout[i];
-        if (slot.get_petal_id() != PetalID::kSponge) continue;
+    uint16_t const slots = get_loadout_summary(player).sponge_slots;
+    for (uint32_t i = 0; slots != 0 && i < player.get_loadout_count(); ++i) {
+        if (!BitMath::at(slots, i)) continue;
+        LoadoutSlot &slot = player.loadout()[i];
         for (uint32_t j = 0; j < slot.size(); ++j) {
             LoadoutPetal &petal_slot = slot.petals[j];
             if (sim->ent_alive(petal_slot.ent_id))
@@ -66,7 +68,7 @@ void inflict_damage(Simulation *sim, EntityID const atk_id, EntityID const def_i
                     DEBUG_ONLY(assert(period <= MAX_SPONGE_PERIOD);)
                     float dmg = amt / period;
                     for (uint32_t i = 0; i < period; ++i)
-                        defender.delayed_damage[i] += dmg;
+                        defender.delayed_damage()[i] += dmg;
                     amt = 0;
                 }
             }
@@ -116,7 +118,7 @@ void inflict_damage(Simulation *sim, EntityID const atk_id, EntityID const def_i
             defender.honey_ticks = 0;
             defender.immunity_ticks = 1.0 * TPS;
             for (uint32_t i = 0; i < MAX_SPONGE_PERIOD; ++i)
-                defender.delayed_damage[i] = 0;
+                defender.delayed_damage()[i] = 0;
         }
     }
     if (!sim->ent_exists(atk_id)) return;
@@ -19,7 +19,7 @@ static void _alloc_drops(Simulation *sim, std::vector<PetalID::T> &success_drops
     size_t count = success_drops.size();
     for (size_t i = count; i > 0; --i) {
         PetalID::T drop_id = success_drops[i - 1];
-        if (PETAL_DATA[drop_id].rarity == RarityID::kUnique && PetalTracker::get_count(drop_id) > 0) {
+        if (PETAL_DATA[drop_id].rarity == RarityID::kUnique && !PetalTracker::can_grant_unique(sim, drop_id)) {
             success_drops[i - 1] = success_drops[count - 1];
             --count;
             success_drops.pop_back();
@@ -58,7 +58,10 @@ void entity_on_death(Simulation *sim, Entity const &ent) {
             Entity const &killer = sim->get_ent(ent.last_damaged_by);
             if (killer.has_component(kName)) camera.set_killed_by(killer.get_name());
             else camera.set_killed_by("");
-        } else if (ent.poison_ticks > 0) camera.set_killed_by("Poison");
+        } else if (ent.poison_ticks > 0) {
+            static InternedString const POISON = InternedString::pinned("Poison");
+            camera.set_killed_by(POISON);
+        }
         else camera.set_killed_by("");
     }
     if (ent.has_component(kMob)) {
@@ -94,8 +97,8 @@ void entity_on_death(Simulation *sim, Entity const &ent) {
             if (get_sponge_period(sim, parent) == 0) {
                 float dmg = 0;
                 for (uint32_t i = 0; i < MAX_SPONGE_PERIOD; ++i) {
-                    dmg += parent.delayed_damage[i];
-                    parent.delayed_damage[i] = 0;
+                    dmg += parent.delayed_damage()[i];
+                    parent.delayed_damage()[i] = 0;
                 }
                 inflict_damage(sim, parent.last_damaged_by, parent.id, dmg, DamageType::kSponge);
             }
@@ -104,15 +107,15 @@ void entity_on_death(Simulation *sim, Entity const &ent) {
         std::vector<PetalID::T> potential = {};
         for (uint32_t i = 0; i < ent.get_loadout_count() + MAX_SLOT_COUNT; ++i) {
             DEBUG_ONLY(assert(ent.get_loadout_ids(i) < PetalID::kNumPetals));
-            PetalTracker::remove_petal(ent.get_loadout_ids(i));
+            PetalTracker::remove_petal(sim, ent.get_loadout_ids(i));
             if (ent.get_loadout_ids(i) != PetalID::kNone && ent.get_loadout_ids(i) != PetalID::kBasic && frand() < 0.95)
                 potential.push_back(ent.get_loadout_ids(i));
         }
-        for (uint32_t i = 0; i < ent.deleted_petals.size(); ++i) {
-            DEBUG_ONLY(assert(ent.deleted_petals[i] < PetalID::kNumPetals));
-            PetalTracker::remove_petal(ent.deleted_petals[i]);
-            if (ent.deleted_petals[i] != PetalID::kNone && ent.deleted_petals[i] != PetalID::kBasic && frand() < 0.95)
-                potential.push_back(ent.deleted_petals[i]);
+        for (uint32_t i = 0; i < ent.deleted_petals().size(); ++i) {
+            DEBUG_ONLY(assert(ent.deleted_petals()[i] < PetalID::kNumPetals));
+            PetalTracker::remove_petal(sim, ent.deleted_petals()[i]);
+            if (ent.deleted_petals()[i] != PetalID::kNone && ent.deleted_petals()[i] != PetalID::kBasic && frand() < 0.95)
+                potential.push_back(ent.deleted_petals()[i]);
         }
         //no need to deleted_petals.clear, the player dies
         std::sort(potential.begin(), potential.end(), [](PetalID::T a, PetalID::T b) {
@@ -148,7 +151,7 @@ void entity_on_death(Simulation *sim, Entity const &ent) {
             camera.set_inventory(i, PetalID::kNone); //force reset
         for (uint32_t i = 0; i < num_left; ++i) {
             DEBUG_ONLY(assert(potential.back() < PetalID::kNumPetals));
-            PetalTracker::add_petal(potential.back());
+            PetalTracker::add_petal(sim, potential.back());
             camera.set_inventory(i, potential.back());
             potential.pop_back();
         }
@@ -157,19 +160,22 @@ void entity_on_death(Simulation *sim, Entity const &ent) {
             camera.set_inventory(i, PetalID::kNone); //don't track kNone
         //fill with basics
         for (uint32_t i = num_left; i < loadout_slots_at_level(respawn_level); ++i) {
-            PetalTracker::add_petal(PetalID::kBasic);
+            PetalTracker::add_petal(sim, PetalID::kBasic);
             camera.set_inventory(i, PetalID::kBasic);
         }
     } else if (ent.has_component(kDrop)) {
         if (BitMath::at(ent.flags, EntityFlags::kIsDespawning))
-            PetalTracker::remove_petal(ent.get_drop_id());
+            PetalTracker::remove_petal(sim, ent.get_drop_id());
     } else if (ent.has_component(kCamera)) {
-        --Server::player_count;
+        sim->camera_count.fetch_sub(1, std::memory_order_relaxed);
+        auto recovery = sim->recovery_ids.find(ent.get_recovery_id());
+        if (recovery != sim->recovery_ids.end() && recovery->second == ent.id)
+            sim->recovery_ids.erase(recovery);
         if (sim->arena_info.gamemode == Gamemode::kTDM)
             --sim->get_ent(ent.get_team()).player_count;
         if (sim->ent_exists(ent.get_player()))
             sim->request_delete(ent.get_player());
         for (uint32_t i = 0; i < 2 * MAX_SLOT_COUNT; ++i)
-            PetalTracker::remove_petal(ent.get_inventory(i));
+            PetalTracker::remove_petal(sim, ent.get_inventory(i));
     }
 }
\ No newline at end of file
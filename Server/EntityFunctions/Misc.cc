@@ -5,6 +5,8 @@
 #include <Shared/Entity.hh>
 #include <Shared/Simulation.hh>
 
+#include <algorithm>
+#include <cmath>
 #include <type_traits>
 
 void entity_set_despawn_tick(Entity &ent, game_tick_t t) {
@@ -54,9 +56,59 @@ void delete_petal(Simulation *simulation, Entity &player, PetalID::T old_id) {
         uint8_t rarity = PETAL_DATA[old_id].rarity;
         player.set_score(player.get_score() + RARITY_TO_XP[rarity]);
         //need to delete if over cap
-        if (player.deleted_petals.size() == player.deleted_petals.capacity())
+        if (player.deleted_petals().size() == player.deleted_petals().capacity())
             //removes old trashed petal
-            PetalTracker::remove_petal(player.deleted_petals[0]);
-        player.deleted_petals.push_back(old_id);
+            PetalTracker::remove_petal(simulation, player.deleted_petals()[0]);
+        player.deleted_petals().push_back(old_id);
     }
 }
+
+LoadoutSummary const &get_loadout_summary(Entity &player) {
+    LoadoutSummary &summary = player.loadout_summary();
+    uint8_t const disabled = player.get_overlevel_timer() >= PETAL_DISABLE_DELAY * TPS;
+    if (!summary.dirty && summary.loadout_count == player.get_loadout_count() && summary.disabled == disabled)
+        return summary;
+    summary = LoadoutSummary();
+    summary.dirty = 0;
+    summary.loadout_count = player.get_loadout_count();
+    summary.disabled = disabled;
+    for (uint32_t i = 0; i < player.get_loadout_count(); ++i) {
+        PetalID::T const slot_petal_id = player.loadout()[i].get_petal_id();
+        if (slot_petal_id == PetalID::kSponge) BitMath::set(summary.sponge_slots, i);
+        else if (slot_petal_id == PetalID::kYggdrasil) BitMath::set(summary.yggdrasil_slots, i);
+    }
+    if (player.has_component(kMob) || disabled) return summary;
+    for (uint32_t i = 0; i < player.get_loadout_count(); ++i) {
+        LoadoutSlot const &slot = player.loadout()[i];
+        PetalID::T const slot_petal_id = slot.get_petal_id();
+        struct PetalAttributes const &attrs = PETAL_DATA[slot_petal_id].attributes;
+        if (attrs.equipment != EquipmentFlags::kNone)
+            summary.equip_flags |= 1 << attrs.equipment;
+        summary.vision_factor = std::min(summary.vision_factor, attrs.vision_factor);
+        summary.extra_range = std::fmax(attrs.extra_range, summary.extra_range);
+        summary.extra_damage = std::fmax(summary.extra_damage, attrs.extra_body_damage);
+        summary.damage_factor *= attrs.extra_damage_factor;
+        summary.reload_factor *= attrs.extra_reload_factor;
+        if (slot_petal_id == PetalID::kYinYang)
+            ++summary.yinyang_count;
+        if (!slot.already_spawned) continue;
+        if (slot_petal_id == PetalID::kLeaf)
+            summary.heal += attrs.constant_heal / TPS;
+        else if (slot_petal_id == PetalID::kYucca)
+            summary.defending_heal += attrs.constant_heal / TPS;
+        summary.extra_rot += attrs.extra_rotation_speed;
+        summary.extra_health += attrs.extra_health;
+        summary.extra_radius += attrs.extra_radius;
+        summary.health_factor *= attrs.health_factor;
+        summary.speed_factor *= attrs.speed_factor;
+        summary.damage_reflection = std::fmax(summary.damage_reflection, attrs.damage_reflection);
+        summary.poison_armor = std::fmax(summary.poison_armor, attrs.poison_armor / TPS);
+        if (slot_petal_id == PetalID::kPoisonCactus)
+            summary.is_poisonous = 1;
+        if (slot_petal_id == PetalID::kGoldenLeaf) {
+            summary.damage_factor *= 1.2;
+            summary.reload_factor *= 1.2;
+        }
+    }
+    return summary;
+}
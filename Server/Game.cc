@@ -1,16 +1,22 @@
 #include <Server/Game.hh>
 
+#include <Server/Bandwidth.hh>
 #include <Server/Client.hh>
 #include <Server/EntityFunctions.hh>
 #include <Server/PetalTracker.hh>
 #include <Server/Server.hh>
 #include <Server/Spawn.hh>
+#include <Server/Trace.hh>
 
 #include <Shared/Binary.hh>
 #include <Shared/Entity.hh>
 #include <Shared/Map.hh>
 
-static void _update_client(Simulation *sim, Client *client) {
+//each game may build its packets on its own thread
+static thread_local uint8_t OUTGOING_PACKET[MAX_PACKET_LEN] = {0};
+
+static void _update_client(GameInstance *game, Simulation *sim, Client *client) {
+    TRACE_SPAN("update_client");
     if (client == nullptr) return;
     if (!client->verified) return;
     if (sim == nullptr) return;
@@ -22,18 +28,20 @@ static void _update_client(Simulation *sim, Client *client) {
     if (sim->ent_exists(camera.get_player())) 
         in_view.insert(camera.get_player());
     if (sim->arena_info.gamemode == Gamemode::kTDM) {
-        Entity &team = sim->get_ent(camera.get_team());
-        in_view.insert(team.minimap_dots.begin(), team.minimap_dots.end());
+        std::set<EntityID> const &minimap_dots = game->get_team_manager().get_minimap_dots(camera.get_team());
+        in_view.insert(minimap_dots.begin(), minimap_dots.end());
     }
     for (EntityID dot_id : sim->arena_info.leader_dots) {
         if (sim->get_ent(dot_id).get_team() != camera.get_team())
             in_view.insert(dot_id);
     }
-    Writer writer(Server::OUTGOING_PACKET);
-    writer.write<uint8_t>(Clientbound::kClientUpdate);
-    writer.write<uint8_t>(client->seen_arena);
-    writer.write<uint8_t>(Server::is_draining);
-    writer.write<EntityID>(client->camera);
+    Writer writer(OUTGOING_PACKET);
+    RECORD_BANDWIDTH(overhead, Bandwidth::kPacketHeader, 0, &writer,
+        writer.write<uint8_t>(Clientbound::kClientUpdate);
+        writer.write<uint8_t>(client->seen_arena);
+        writer.write<uint8_t>(Server::is_draining);
+        writer.write<EntityID>(client->camera);
+    )
     sim->spatial_hash.query(camera.get_camera_x(), camera.get_camera_y(), 
     960 / camera.get_fov() + 100, 540 / camera.get_fov() + 100, 
     [&](Simulation *, Entity &ent){
@@ -42,11 +50,17 @@ static void _update_client(Simulation *sim, Client *client) {
             if (sim->ent_exists(ent.get_seg_head())) in_view.insert(ent.get_seg_head());
             if (sim->ent_exists(ent.get_seg_tail())) in_view.insert(ent.get_seg_tail());
         }
+        #ifdef ORBIT_PREDICTION
+        //the client moves orbiting petals from their flower's orbit
+        if (ent.has_component(kPetal) && BitMath::at(ent.get_petal_flags(), PetalFlags::kOrbiting)
+            && sim->ent_exists(ent.get_parent()))
+            in_view.insert(ent.get_parent());
+        #endif
     });
 
     for (EntityID const &i: client->in_view) {
         if (!in_view.contains(i)) {
-            writer.write<EntityID>(i);
+            RECORD_BANDWIDTH(overhead, Bandwidth::kDeletes, 0, &writer, writer.write<EntityID>(i);)
             deletes.push_back(i);
         }
     }
@@ -54,27 +68,43 @@ static void _update_client(Simulation *sim, Client *client) {
     for (EntityID const &i : deletes)
         client->in_view.erase(i);
 
-    writer.write<EntityID>(NULL_ENTITY);
+    RECORD_BANDWIDTH(overhead, Bandwidth::kDeletes, 0, &writer, writer.write<EntityID>(NULL_ENTITY);)
     //upcreates
     for (EntityID id: in_view) {
         DEBUG_ONLY(assert(sim->ent_exists(id));)
         Entity &ent = sim->get_ent(id);
         uint8_t create = !client->in_view.contains(id);
-        writer.write<EntityID>(id);
-        writer.write<uint8_t>(create | (ent.pending_delete << 1));
+        RECORD_BANDWIDTH(overhead, Bandwidth::kEntityIds, create, &writer,
+            writer.write<EntityID>(id);
+            writer.write<uint8_t>(create | (ent.pending_delete << 1));
+        )
         ent.write(&writer, BitMath::at(create, 0));
+        #ifdef DEAD_RECKONING
+        //a create carries the real position, not the extrapolated one the other clients are on
+        if (create && ent.has_component(kMob)) ent.reckoning_resync = 1;
+        #endif
         client->in_view.insert(id);
     }
-    writer.write<EntityID>(NULL_ENTITY);
+    RECORD_BANDWIDTH(overhead, Bandwidth::kEntityIds, 0, &writer, writer.write<EntityID>(NULL_ENTITY);)
     //write arena stuff
     sim->arena_info.write(&writer, !client->seen_arena);
     client->seen_arena = 1;
-    client->send_packet(writer.packet, writer.at - writer.packet);
+    game->queue_packet(client, writer.packet, writer.at - writer.packet);
 }
 
-GameInstance::GameInstance(uint8_t mode) : simulation(), clients(), team_manager(&simulation), gamemode(mode) {}
+static char const *GAMEMODE_NAMES[] = { "ffa", "tdm" };
+static_assert(sizeof(GAMEMODE_NAMES) / sizeof(GAMEMODE_NAMES[0]) == Gamemode::kNumGamemodes);
+
+GameInstance::GameInstance(uint8_t mode) : simulation(), clients(), team_manager(&simulation), seed(0), gamemode(mode) {}
 
 void GameInstance::init() {
+    init((static_cast<uint64_t>(std::rand()) << 32) | std::rand());
+}
+
+void GameInstance::init(uint64_t s) {
+    seed = s;
+    simulation.rng.seed(seed);
+    RngScope rng_scope(simulation.rng);
     simulation.arena_info.set_gamemode(gamemode);
     for (uint32_t i = 0; i < ENTITY_CAP / 2; ++i)
         Map::spawn_random_mob(&simulation, frand() * ARENA_WIDTH, frand() * ARENA_HEIGHT);
@@ -84,17 +114,121 @@ void GameInstance::init() {
     }
 }
 
+void GameInstance::save(Snapshot::Writer &writer) const {
+    writer.write<uint8_t>(gamemode);
+    writer.write<uint64_t>(seed);
+    simulation.save(writer);
+    team_manager.save(writer);
+}
+
+//clients do not survive a restart, their cameras wait as zombies for them to reconnect
+bool GameInstance::load(Snapshot::Reader &reader) {
+    uint8_t mode = 0;
+    reader.read<uint8_t>(mode);
+    reader.read<uint64_t>(seed);
+    if (reader.failed || mode != gamemode || !simulation.load(reader) || !team_manager.load(reader)) {
+        simulation.reset();
+        return false;
+    }
+    simulation.arena_info.set_gamemode(gamemode);
+    simulation.for_each<kCamera>([](Simulation *, Entity &camera) {
+        if (BitMath::at(camera.flags, EntityFlags::kCPUControlled)) return;
+        BitMath::set(camera.flags, EntityFlags::kZombie);
+    });
+    return true;
+}
+
+char const *GameInstance::get_name() const {
+    return GAMEMODE_NAMES[gamemode];
+}
+
 void GameInstance::tick() {
-    simulation.tick();
-    if (gamemode == Gamemode::kTDM)
-        team_manager.tick();
-    for (Client *client : clients)
-        _update_client(&simulation, client);
-    simulation.post_tick();
+    PROFILE_ONLY(Profiler::TickRecord &record = flight_recorder.begin();)
+    {
+        TRACE_SPAN("game_tick");
+        PROFILE_SCOPE(kGameTick);
+        RngScope rng_scope(simulation.rng);
+        {
+            PROFILE_SCOPE(kSimulation);
+            simulation.tick();
+        }
+        if (gamemode == Gamemode::kTDM) {
+            PROFILE_SCOPE(kTeamManager);
+            team_manager.tick();
+        }
+        {
+            PROFILE_SCOPE(kUpdateClients);
+            for (Client *client : clients)
+                _update_client(this, &simulation, client);
+        }
+        PROFILE_ONLY(record.entity_count = simulation.active_entity_count();)
+        PROFILE_ONLY(record.client_count = clients.size();)
+        PROFILE_ONLY(record.packet_count = pending_packets.size();)
+        PROFILE_ONLY(record.packet_bytes = outgoing.size();)
+        #ifndef WASM_SERVER
+        metrics.sample(&simulation, clients.size(), outgoing.size());
+        #endif
+        PROFILE_SCOPE(kPostTick);
+        simulation.post_tick();
+    }
+    PROFILE_ONLY(flight_recorder.end();)
 }
 
+#ifdef PROFILER
+void GameInstance::dump_flight_recorder() {
+    flight_recorder.dump(get_name());
+}
+#endif
+
+void GameInstance::queue_packet(Client *client, uint8_t const *packet, size_t size) {
+    pending_packets.push_back({client, outgoing.size(), size});
+    outgoing.insert(outgoing.end(), packet, packet + size);
+}
+
+void GameInstance::flush() {
+    for (PendingPacket const &pending : pending_packets) {
+        TRACE_SPAN("send");
+        pending.client->send_packet(outgoing.data() + pending.offset, pending.size);
+    }
+    pending_packets.clear();
+    outgoing.clear();
+}
+
+#ifndef WASM_SERVER
+GameInstance::~GameInstance() {
+    if (!worker.joinable()) return;
+    worker_stopping = true;
+    tick_requested.release();
+    worker.join();
+}
+
+void GameInstance::start_worker() {
+    DEBUG_ONLY(assert(!worker.joinable());)
+    worker = std::thread([this](){
+        Trace::name_thread(get_name());
+        while (1) {
+            tick_requested.acquire();
+            if (worker_stopping) return;
+            tick();
+            tick_finished.release();
+        }
+    });
+}
+
+//the socket thread stays blocked between begin_tick and end_tick,
+//so clients and inputs are never touched while the simulation runs
+void GameInstance::begin_tick() {
+    tick_requested.release();
+}
+
+void GameInstance::end_tick() {
+    tick_finished.acquire();
+}
+#endif
+
 void GameInstance::add_client(Client *client, EntityID camera_id) {
     DEBUG_ONLY(assert(client->game != this);)
+    RngScope rng_scope(simulation.rng);
     if (client->game != nullptr)
         client->game->remove_client(client);
     client->game = this;
@@ -124,4 +258,51 @@ void GameInstance::remove_client(Client *client) {
         camera.client = nullptr;
     }
     client->game = nullptr;
-}
\ No newline at end of file
+}
+void GameInstance::disconnect_all(int reason, std::string const &message) {
+    std::vector<Client *> to_disconnect(clients.begin(), clients.end());
+    for (Client *client : to_disconnect) client->disconnect(reason, message);
+}
+
+//the session comes back as a zombie camera, exactly like a client that just dropped
+bool GameInstance::restore_session(Handover::Session const &session) {
+    if (simulation.recovery_ids.contains(session.recovery_id)) return false;
+    RngScope rng_scope(simulation.rng);
+    EntityID team;
+    if (gamemode == Gamemode::kTDM)
+        team = team_manager.get_random_team();
+    Entity &camera = alloc_camera(&simulation, team);
+    simulation.recovery_ids.erase(camera.get_recovery_id());
+    camera.set_recovery_id(session.recovery_id);
+    simulation.recovery_ids[session.recovery_id] = camera.id;
+    BitMath::set(camera.flags, EntityFlags::kZombie);
+    camera.set_dev(session.dev);
+    //spawn at the flower's level with its loadout as the inventory, then put the rest back
+    uint32_t const level = std::min(score_to_level(session.score), MAX_LEVEL);
+    camera.set_respawn_level(session.has_player ? level : session.respawn_level);
+    for (uint32_t i = 0; i < 2 * MAX_SLOT_COUNT; ++i) {
+        PetalTracker::remove_petal(&simulation, camera.get_inventory(i));
+        camera.set_inventory(i, session.has_player ? session.loadout_ids[i] : session.inventory[i]);
+        PetalTracker::add_petal(&simulation, camera.get_inventory(i));
+    }
+    if (!session.has_player) return true;
+    Entity &player = alloc_player(&simulation, camera.get_team());
+    player_spawn(&simulation, camera, player);
+    camera.set_respawn_level(session.respawn_level);
+    for (uint32_t i = 0; i < 2 * MAX_SLOT_COUNT; ++i) {
+        PetalTracker::remove_petal(&simulation, camera.get_inventory(i));
+        camera.set_inventory(i, session.inventory[i]);
+        PetalTracker::add_petal(&simulation, camera.get_inventory(i));
+    }
+    player.set_name(session.name);
+    player.set_dev(session.dev);
+    player.set_score(session.score);
+    player.set_x(session.x);
+    player.set_y(session.y);
+    camera.set_camera_x(session.x);
+    camera.set_camera_y(session.y);
+    player.health = player.max_health * session.health_ratio;
+    player.set_health_ratio(session.health_ratio);
+    player.immunity_ticks = 3 * TPS;
+    return true;
+}
@@ -1,22 +1,66 @@
 #pragma once
 
+#include <Server/Handover.hh>
+#include <Server/Metrics.hh>
+#include <Server/Profiler.hh>
+#include <Server/Snapshot.hh>
 #include <Server/TeamManager.hh>
 
 #include <Shared/Simulation.hh>
 
 #include <set>
+#include <string>
+#include <vector>
+
+#ifndef WASM_SERVER
+#include <semaphore>
+#include <thread>
+#endif
 
 class Client;
 
 class GameInstance {
+    struct PendingPacket {
+        Client *client;
+        size_t offset;
+        size_t size;
+    };
     std::set<Client *> clients;
     TeamManager team_manager;
+    //packets built during tick, sent by flush on the socket thread
+    std::vector<uint8_t> outgoing;
+    std::vector<PendingPacket> pending_packets;
+    #ifndef WASM_SERVER
+    std::thread worker;
+    std::binary_semaphore tick_requested{0};
+    std::binary_semaphore tick_finished{0};
+    bool worker_stopping = false;
+    #endif
+    PROFILE_ONLY(Profiler::FlightRecorder flight_recorder;)
 public:
     Simulation simulation;
+    uint64_t seed;
     uint8_t gamemode;
     GameInstance(uint8_t);
+    #ifndef WASM_SERVER
+    Metrics::GameMetrics metrics;
+    ~GameInstance();
+    void start_worker();
+    void begin_tick();
+    void end_tick();
+    #endif
     void init();
+    void init(uint64_t);
+    void save(Snapshot::Writer &) const;
+    bool load(Snapshot::Reader &);
+    char const *get_name() const;
+    TeamManager const &get_team_manager() const { return team_manager; }
     void tick();
+    void flush();
+    PROFILE_ONLY(void dump_flight_recorder();)
+    void queue_packet(Client *, uint8_t const *, size_t);
     void add_client(Client *, EntityID);
     void remove_client(Client *);
+    void disconnect_all(int, std::string const &);
+    bool restore_session(Handover::Session const &);
 };
\ No newline at end of file
@@ -0,0 +1,271 @@
+#include <Server/Handover.hh>
+
+#include <Server/Game.hh>
+#include <Server/Journal.hh>
+#include <Server/Log.hh>
+#include <Server/Server.hh>
+
+#include <Shared/Config.hh>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#ifdef WASM_SERVER
+#include <emscripten.h>
+#endif
+
+using namespace Handover;
+
+static uint32_t ticks_since_poll = 0;
+
+template<typename T>
+static void _push(std::vector<uint8_t> &buffer, T const &v) {
+    size_t const at = buffer.size();
+    buffer.resize(at + sizeof(T));
+    std::memcpy(buffer.data() + at, &v, sizeof(T));
+}
+
+class SnapshotReader {
+    std::vector<uint8_t> const &data;
+    size_t at = 0;
+public:
+    bool failed = false;
+    SnapshotReader(std::vector<uint8_t> const &bytes) : data(bytes) {}
+    template<typename T>
+    T read() {
+        T v{};
+        if (at + sizeof(T) > data.size()) {
+            failed = true;
+            return v;
+        }
+        std::memcpy(&v, data.data() + at, sizeof(T));
+        at += sizeof(T);
+        return v;
+    }
+    void read_string(std::string &str, uint32_t max_size) {
+        uint32_t size = read<uint32_t>();
+        if (failed || size > max_size || at + size > data.size()) {
+            failed = true;
+            return;
+        }
+        str.assign(reinterpret_cast<char const *>(data.data() + at), size);
+        at += size;
+    }
+};
+
+static uint64_t _now() {
+    return std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+#ifdef WASM_SERVER
+//emscripten's filesystem and environment are sandboxed, go through node instead
+static bool _is_enabled() {
+    return EM_ASM_INT({ return process.env.GARDN_HANDOVER ? 1 : 0; });
+}
+
+static bool _write_file(std::vector<uint8_t> const &bytes) {
+    return EM_ASM_INT({
+        const fs = require("fs");
+        const path = process.env.GARDN_HANDOVER;
+        try {
+            fs.writeFileSync(path + ".tmp", HEAPU8.subarray($0, $0 + $1));
+            fs.renameSync(path + ".tmp", path);
+            return 1;
+        } catch (e) {
+            return 0;
+        }
+    }, bytes.data(), bytes.size());
+}
+
+static bool _take_file(std::vector<uint8_t> &bytes) {
+    int size = EM_ASM_INT({
+        const fs = require("fs");
+        const path = process.env.GARDN_HANDOVER;
+        if (!fs.existsSync(path)) return -1;
+        try {
+            Module.handover = fs.readFileSync(path);
+            fs.unlinkSync(path);
+            return Module.handover.length;
+        } catch (e) {
+            return -1;
+        }
+    });
+    if (size < 0) return false;
+    bytes.resize(size);
+    EM_ASM({
+        HEAPU8.set(Module.handover, $0);
+        delete Module.handover;
+    }, bytes.data());
+    return true;
+}
+#else
+//gardn-replay and gardn-bench tick like the server and may share its environment,
+//they must never take or overwrite a live process's handover file
+static bool _is_enabled() {
+    #ifdef HEADLESS_SERVER
+    return false;
+    #else
+    return std::getenv("GARDN_HANDOVER") != nullptr;
+    #endif
+}
+
+//written next to the target and renamed, so the other process never sees half a snapshot
+static bool _write_file(std::vector<uint8_t> const &bytes) {
+    std::string const path = std::getenv("GARDN_HANDOVER");
+    std::string const tmp_path = path + ".tmp";
+    std::FILE *file = std::fopen(tmp_path.c_str(), "wb");
+    if (file == nullptr) return false;
+    bool written = std::fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+    written = std::fclose(file) == 0 && written;
+    if (written && std::rename(tmp_path.c_str(), path.c_str()) == 0) return true;
+    std::remove(tmp_path.c_str());
+    return false;
+}
+
+static bool _take_file(std::vector<uint8_t> &bytes) {
+    char const *path = std::getenv("GARDN_HANDOVER");
+    std::FILE *file = std::fopen(path, "rb");
+    if (file == nullptr) return false;
+    uint8_t chunk[4096];
+    size_t read;
+    while ((read = std::fread(chunk, 1, sizeof(chunk), file)) > 0)
+        bytes.insert(bytes.end(), chunk, chunk + read);
+    std::fclose(file);
+    std::remove(path);
+    return true;
+}
+#endif
+
+static void _write_session(std::vector<uint8_t> &buffer, Session const &session) {
+    _push<uint64_t>(buffer, session.recovery_id);
+    _push<uint8_t>(buffer, session.gamemode);
+    _push<uint8_t>(buffer, session.respawn_level);
+    _push<uint8_t>(buffer, session.dev);
+    for (PetalID::T id : session.inventory) _push<PetalID::T>(buffer, id);
+    _push<uint8_t>(buffer, session.has_player);
+    if (!session.has_player) return;
+    _push<uint32_t>(buffer, session.score);
+    _push<float>(buffer, session.x);
+    _push<float>(buffer, session.y);
+    _push<float>(buffer, session.health_ratio);
+    for (PetalID::T id : session.loadout_ids) _push<PetalID::T>(buffer, id);
+    _push<uint32_t>(buffer, session.name.size());
+    buffer.insert(buffer.end(), session.name.begin(), session.name.end());
+}
+
+static bool _read_session(SnapshotReader &reader, Session &session) {
+    session.recovery_id = reader.read<uint64_t>();
+    session.gamemode = reader.read<uint8_t>();
+    session.respawn_level = reader.read<uint8_t>();
+    session.dev = reader.read<uint8_t>();
+    bool valid = session.gamemode < Gamemode::kNumGamemodes && session.respawn_level <= MAX_LEVEL;
+    for (PetalID::T &id : session.inventory) {
+        id = reader.read<PetalID::T>();
+        valid &= id < PetalID::kNumPetals;
+    }
+    session.has_player = reader.read<uint8_t>();
+    if (session.has_player) {
+        session.score = reader.read<uint32_t>();
+        session.x = reader.read<float>();
+        session.y = reader.read<float>();
+        session.health_ratio = reader.read<float>();
+        for (PetalID::T &id : session.loadout_ids) {
+            id = reader.read<PetalID::T>();
+            valid &= id < PetalID::kNumPetals;
+        }
+        reader.read_string(session.name, MAX_NAME_LENGTH);
+        valid &= session.x >= 0 && session.x <= ARENA_WIDTH && session.y >= 0 && session.y <= ARENA_HEIGHT;
+        valid &= session.health_ratio > 0 && session.health_ratio <= 1;
+    }
+    return valid && !reader.failed;
+}
+
+bool Handover::save() {
+    if (!_is_enabled()) return false;
+    std::vector<uint8_t> buffer;
+    uint32_t count = 0;
+    _push<uint64_t>(buffer, MAGIC);
+    _push<uint32_t>(buffer, VERSION);
+    _push<uint64_t>(buffer, _now());
+    size_t const count_at = buffer.size();
+    _push<uint32_t>(buffer, 0);
+    for (GameInstance &game : Server::games) {
+        Simulation *sim = &game.simulation;
+        sim->for_each<kCamera>([&](Simulation *, Entity &camera) {
+            if (BitMath::at(camera.flags, EntityFlags::kCPUControlled)) return;
+            Session session;
+            session.recovery_id = camera.get_recovery_id();
+            session.gamemode = game.gamemode;
+            session.respawn_level = camera.get_respawn_level();
+            session.dev = camera.get_dev();
+            for (uint32_t i = 0; i < 2 * MAX_SLOT_COUNT; ++i)
+                session.inventory[i] = camera.get_inventory(i);
+            //a flower dying this tick comes back as a camera waiting to respawn
+            session.has_player = sim->ent_alive(camera.get_player())
+                && sim->get_ent(camera.get_player()).health > 0;
+            if (session.has_player) {
+                Entity &player = sim->get_ent(camera.get_player());
+                session.score = player.get_score();
+                session.x = player.get_x();
+                session.y = player.get_y();
+                session.health_ratio = player.health / player.max_health;
+                for (uint32_t i = 0; i < 2 * MAX_SLOT_COUNT; ++i)
+                    session.loadout_ids[i] = player.get_loadout_ids(i);
+                session.name = player.get_name();
+            }
+            _write_session(buffer, session);
+            ++count;
+        });
+    }
+    std::memcpy(buffer.data() + count_at, &count, sizeof(count));
+    if (!_write_file(buffer)) {
+        Log::info("could not write handover snapshot");
+        return false;
+    }
+    Log::info("handed over " + std::to_string(count) + " sessions (" + std::to_string(buffer.size()) + " bytes)");
+    return true;
+}
+
+//the next process is started before the old one drains, so it keeps looking for a snapshot
+void Handover::poll() {
+    if (Server::is_draining) return;
+    if (ticks_since_poll++ % TPS != 0) return;
+    if (!_is_enabled()) return;
+    std::vector<uint8_t> bytes;
+    if (!_take_file(bytes)) return;
+    SnapshotReader reader(bytes);
+    if (reader.read<uint64_t>() != MAGIC || reader.read<uint32_t>() != VERSION) {
+        Log::info("ignoring handover snapshot with an unknown format");
+        return;
+    }
+    uint64_t const written_at = reader.read<uint64_t>();
+    if (_now() > written_at + MAX_AGE_SECONDS) {
+        Log::info("ignoring stale handover snapshot");
+        return;
+    }
+    Journal::record_handover(bytes);
+    restore(bytes);
+}
+
+uint32_t Handover::restore(std::vector<uint8_t> const &bytes) {
+    SnapshotReader reader(bytes);
+    //format and age were checked by poll()
+    reader.read<uint64_t>();
+    reader.read<uint32_t>();
+    reader.read<uint64_t>();
+    uint32_t const count = reader.read<uint32_t>();
+    uint32_t restored = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        Session session;
+        bool const valid = _read_session(reader, session);
+        if (reader.failed) break;
+        if (!valid) continue;
+        restored += Server::games[session.gamemode].restore_session(session);
+    }
+    Log::info("took over " + std::to_string(restored) + '/' + std::to_string(count) + " sessions");
+    return restored;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <Shared/StaticDefinitions.hh>
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//moves live sessions to the next server process on deploy
+//the draining process writes every camera and its flower to GARDN_HANDOVER and
+//sends its clients away, the process taking over picks the file up and recreates
+//them as zombie cameras under the same recovery ids so reconnecting clients resume
+namespace Handover {
+    uint64_t const MAGIC = 0x4f444e484e445247ull; //GRDNHNDO
+    uint32_t const VERSION = 1;
+    //zombie flowers die within a minute, anything older is stale
+    uint64_t const MAX_AGE_SECONDS = 60;
+
+    struct Session {
+        uint64_t recovery_id;
+        uint8_t gamemode;
+        uint8_t respawn_level;
+        uint8_t dev;
+        std::array<PetalID::T, 2 * MAX_SLOT_COUNT> inventory;
+        uint8_t has_player;
+        uint32_t score;
+        float x;
+        float y;
+        float health_ratio;
+        std::array<PetalID::T, 2 * MAX_SLOT_COUNT> loadout_ids;
+        std::string name;
+    };
+
+    //all run on the socket thread between ticks
+    bool save();
+    void poll();
+    //recreates the sessions of a snapshot poll() accepted, returns how many
+    //gardn-replay feeds journaled snapshots back through here
+    uint32_t restore(std::vector<uint8_t> const &);
+}
@@ -0,0 +1,61 @@
+#ifdef HEADLESS_SERVER
+#include <Server/Headless.hh>
+
+#include <Server/Client.hh>
+#include <Server/Log.hh>
+#include <Server/Server.hh>
+
+static int next_ws_id = 0;
+static uint64_t bytes_sent = 0;
+
+WebSocket *Headless::connect() {
+    return new WebSocket(next_ws_id++);
+}
+
+void Headless::message(WebSocket *ws, std::string_view message) {
+    Client::on_message(ws, message, 0);
+}
+
+void Headless::disconnect(WebSocket *ws, int code) {
+    Client::on_disconnect(ws, code, {});
+    delete ws;
+}
+
+uint64_t Headless::get_bytes_sent() {
+    return bytes_sent;
+}
+
+void Server::init() {
+    for (GameInstance &game : Server::games) {
+        game.init();
+        game.start_worker();
+    }
+}
+
+void Server::run() {}
+
+void Server::stop() {
+    Server::is_stopping = true;
+    Log::info("stopping...");
+}
+
+void Client::send_packet(uint8_t const *packet, size_t size) {
+    if (ws == nullptr) return;
+    ws->send(packet, size);
+}
+
+WebSocket::WebSocket(int id) : ws_id(id) {
+    client.ws = this;
+}
+
+void WebSocket::send(uint8_t const *packet, size_t size) {
+    bytes_sent += size;
+}
+
+//the driver decides when a connection actually closes
+void WebSocket::end(int code, std::string const &message) {}
+
+Client *WebSocket::getUserData() {
+    return &client;
+}
+#endif
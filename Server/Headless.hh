@@ -0,0 +1,16 @@
+#pragma once
+
+#ifdef HEADLESS_SERVER
+#include <Server/Client.hh>
+
+#include <cstdint>
+#include <string_view>
+
+//in-process transport for offline tools, no sockets involved
+namespace Headless {
+    WebSocket *connect();
+    void message(WebSocket *, std::string_view);
+    void disconnect(WebSocket *, int);
+    uint64_t get_bytes_sent();
+}
+#endif
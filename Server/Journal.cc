@@ -0,0 +1,121 @@
+#include <Server/Journal.hh>
+
+#include <Server/Client.hh>
+#include <Server/Log.hh>
+#include <Server/Server.hh>
+
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+static std::FILE *journal_file = nullptr;
+static std::vector<uint8_t> buffer;
+static uint32_t next_connection_id = 1;
+static bool drain_recorded = false;
+
+static uint64_t _draw_recovery_id() {
+    //straight from the os, an engine seeded once could be recovered from the ids a client sees
+    std::random_device device;
+    return (static_cast<uint64_t>(device()) << 32) | device();
+}
+
+static uint64_t pending_recovery_id = _draw_recovery_id();
+static bool replaying_recovery_ids = false;
+
+template<typename T>
+static void _push(T const &v) {
+    uint8_t const *bytes = reinterpret_cast<uint8_t const *>(&v);
+    buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+}
+
+//draining is flipped by a signal, so note it before the first event that could observe it
+static void _push_record(Journal::Record type) {
+    if (Server::is_draining && !drain_recorded) {
+        drain_recorded = true;
+        _push<uint8_t>(Journal::kDrain);
+    }
+    _push<uint8_t>(type);
+}
+
+void Journal::init(bool warm_start) {
+    char const *path = std::getenv("GARDN_JOURNAL");
+    if (path == nullptr) return;
+    //a journal replays the games from their seeds, a restored game cannot be reproduced
+    if (warm_start) {
+        Log::info("not journaling, games were restored from a snapshot");
+        return;
+    }
+    journal_file = std::fopen(path, "wb");
+    if (journal_file == nullptr) {
+        Log::info(std::string("could not open journal ") + path);
+        return;
+    }
+    Log::info(std::string("journaling to ") + path);
+    _push<uint64_t>(MAGIC);
+    _push<uint32_t>(VERSION);
+    _push<uint64_t>(VERSION_HASH);
+    _push<uint32_t>(Server::games.size());
+    for (GameInstance const &game : Server::games)
+        _push<uint64_t>(game.seed);
+    _push_record(kRecoveryId);
+    _push<uint64_t>(pending_recovery_id);
+}
+
+bool Journal::is_recording() {
+    return journal_file != nullptr;
+}
+
+void Journal::record_connect(Client *client) {
+    if (journal_file == nullptr) return;
+    client->journal_id = next_connection_id++;
+    _push_record(kConnect);
+    _push<uint32_t>(client->journal_id);
+}
+
+void Journal::record_message(Client *client, std::string_view message) {
+    if (journal_file == nullptr) return;
+    _push_record(kMessage);
+    _push<uint32_t>(client->journal_id);
+    _push<uint32_t>(message.size());
+    buffer.insert(buffer.end(), message.begin(), message.end());
+}
+
+void Journal::record_disconnect(Client *client, int code) {
+    if (journal_file == nullptr) return;
+    _push_record(kDisconnect);
+    _push<uint32_t>(client->journal_id);
+    _push<int32_t>(code);
+}
+
+void Journal::record_handover(std::vector<uint8_t> const &bytes) {
+    if (journal_file == nullptr) return;
+    _push_record(kHandover);
+    _push<uint32_t>(bytes.size());
+    buffer.insert(buffer.end(), bytes.begin(), bytes.end());
+}
+
+void Journal::record_tick() {
+    if (journal_file == nullptr) return;
+    _push_record(kTick);
+    std::fwrite(buffer.data(), 1, buffer.size(), journal_file);
+    std::fflush(journal_file);
+    buffer.clear();
+}
+
+uint64_t Journal::next_recovery_id() {
+    uint64_t const id = pending_recovery_id;
+    if (replaying_recovery_ids) return id;
+    pending_recovery_id = _draw_recovery_id();
+    if (journal_file != nullptr) {
+        _push_record(kRecoveryId);
+        _push<uint64_t>(pending_recovery_id);
+    }
+    return id;
+}
+
+void Journal::replay_recovery_id(uint64_t id) {
+    replaying_recovery_ids = true;
+    pending_recovery_id = id;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+class Client;
+
+//records everything needed to replay the server tick for tick:
+//game seeds, connects, raw client messages, disconnects, draining, handed over sessions
+//and recovery ids
+//enabled by setting GARDN_JOURNAL to an output path, unless the games were restored from a snapshot
+namespace Journal {
+    uint64_t const MAGIC = 0x4c4e524a4e445247ull; //GRDNJRNL
+    uint32_t const VERSION = 3;
+
+    enum Record : uint8_t {
+        kTick,
+        kConnect,
+        kMessage,
+        kDisconnect,
+        kDrain,
+        kHandover,
+        kRecoveryId
+    };
+
+    //warm_start: some game came from GARDN_SNAPSHOT instead of its seed
+    void init(bool warm_start);
+    bool is_recording();
+    void record_connect(Client *);
+    void record_message(Client *, std::string_view);
+    void record_disconnect(Client *, int);
+    //the accepted handover snapshot, replayed through Handover::restore
+    void record_handover(std::vector<uint8_t> const &);
+    void record_tick();
+    //recovery ids are session tokens, so they come from std::random_device and never from
+    //a game's seeded rng, each is journaled before it is handed out
+    uint64_t next_recovery_id();
+    //replays hand out the journaled ids instead of drawing their own
+    void replay_recovery_id(uint64_t);
+}
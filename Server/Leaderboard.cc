@@ -0,0 +1,100 @@
+#include <Server/Leaderboard.hh>
+
+#include <Shared/Simulation.hh>
+
+#include <algorithm>
+
+Leaderboard::Leaderboard() : stamp(0), top_count(0) {}
+
+void Leaderboard::clear() {
+    ranking.clear();
+    by_camera.assign(ENTITY_CAP, {});
+    seen.assign(ENTITY_CAP, 0);
+    stamp = 0;
+    top_count = 0;
+}
+
+bool Leaderboard::_ahead(Entry const &a, Entry const &b) {
+    if (a.score != b.score) return a.score > b.score;
+    return a.camera.id < b.camera.id;
+}
+
+uint32_t Leaderboard::_remove(Entry const &entry) {
+    auto at = std::lower_bound(ranking.begin(), ranking.end(), entry, _ahead);
+    DEBUG_ONLY(assert(at != ranking.end() && at->camera == entry.camera);)
+    uint32_t rank = at - ranking.begin();
+    ranking.erase(at);
+    return rank;
+}
+
+uint32_t Leaderboard::_insert(Entry const &entry) {
+    auto at = std::lower_bound(ranking.begin(), ranking.end(), entry, _ahead);
+    uint32_t rank = at - ranking.begin();
+    ranking.insert(at, entry);
+    return rank;
+}
+
+void Leaderboard::update(Simulation *sim) {
+    ++stamp;
+    //the best rank anything moved into or out of
+    uint32_t changed = LEADERBOARD_SIZE;
+    uint32_t ranked = 0;
+    sim->for_each<kCamera>([&](Simulation *sim, Entity &camera) {
+        seen[camera.id.id] = stamp;
+        Entry now = { 0, camera.id, NULL_ENTITY };
+        if (sim->ent_alive(camera.get_player())) {
+            now.player = camera.get_player();
+            now.score = sim->get_ent(now.player).get_score();
+            ++ranked;
+        }
+        Entry &was = by_camera[camera.id.id];
+        if (was.camera == now.camera && was.player == now.player && was.score == now.score) return;
+        if (!was.player.null()) changed = std::min(changed, _remove(was));
+        if (!now.player.null()) {
+            changed = std::min(changed, _insert(now));
+            //the top rewrite below corrects this if it lands in the top
+            if (!(was.player == now.player)) sim->get_ent(now.player).set_leaderboard_pos(LEADERBOARD_SIZE);
+        }
+        was = now;
+    });
+    //cameras that went away since the last update
+    if (ranked < ranking.size()) {
+        for (uint32_t i = 0; i < ranking.size(); ++i) {
+            if (seen[ranking[i].camera.id] == stamp) continue;
+            by_camera[ranking[i].camera.id] = {};
+            changed = std::min(changed, i);
+        }
+        std::erase_if(ranking, [&](Entry const &entry) { return seen[entry.camera.id] != stamp; });
+    }
+    sim->arena_info.set_player_count(ranking.size());
+    if (changed >= LEADERBOARD_SIZE) return;
+    uint32_t num = std::min<uint32_t>(ranking.size(), LEADERBOARD_SIZE);
+    for (uint32_t i = 0; i < top_count; ++i) {
+        if (!sim->ent_alive(top[i])) continue;
+        uint32_t j = 0;
+        while (j < num && !(ranking[j].player == top[i])) ++j;
+        if (j == num) sim->get_ent(top[i]).set_leaderboard_pos(LEADERBOARD_SIZE);
+    }
+    for (uint32_t i = 0; i < num; ++i) {
+        Entity &player = sim->get_ent(ranking[i].player);
+        player.set_leaderboard_pos(i);
+        sim->arena_info.set_names(i, player.get_name());
+        sim->arena_info.set_scores(i, player.get_score());
+        if (sim->arena_info.gamemode == Gamemode::kTDM)
+            sim->arena_info.set_colors(i, player.get_color());
+        else
+            sim->arena_info.set_colors(i, ColorID::kGreen);
+        top[i] = ranking[i].player;
+    }
+    top_count = num;
+}
+
+EntityID Leaderboard::leader() const {
+    if (ranking.empty()) return NULL_ENTITY;
+    return ranking[0].player;
+}
+
+uint32_t Leaderboard::leader_score() const {
+    if (ranking.empty()) return 0;
+    return ranking[0].score;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <Shared/EntityDef.hh>
+#include <Shared/StaticDefinitions.hh>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+class Simulation;
+
+//every alive player ranked by score, kept sorted across ticks instead of re-sorted
+//ties go to the lower camera id, the order a stable sort over for_each<kCamera> gives
+//each tick only players whose score or player changed are moved, and the arena
+//leaderboard and leaderboard_pos are only rewritten when the top LEADERBOARD_SIZE changes
+class Leaderboard {
+    struct Entry {
+        uint32_t score;
+        EntityID camera;
+        EntityID player;
+    };
+    //best first
+    std::vector<Entry> ranking;
+    //what each camera slot is ranked under, player is null when it is not ranked
+    std::vector<Entry> by_camera;
+    std::vector<uint32_t> seen;
+    uint32_t stamp;
+    std::array<EntityID, LEADERBOARD_SIZE> top;
+    uint32_t top_count;
+    static bool _ahead(Entry const &, Entry const &);
+    //returns the rank it was removed from or inserted at
+    uint32_t _remove(Entry const &);
+    uint32_t _insert(Entry const &);
+public:
+    Leaderboard();
+    void clear();
+    //once per tick, after scores are settled
+    void update(Simulation *);
+    //best ranked player as of the last update, null if nobody is alive
+    EntityID leader() const;
+    uint32_t leader_score() const;
+};
@@ -0,0 +1,214 @@
+#include <Server/Log.hh>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+#ifndef WASM_SERVER
+#include <mutex>
+#include <thread>
+#endif
+
+//names are validated in codepoints when USE_CODEPOINT_LEN is set, so leave room for 4 byte characters
+static uint32_t const NAME_CAPACITY = 64;
+static uint32_t const TEXT_CAPACITY = 256;
+static uint32_t const RING_SIZE = 1024;
+
+static char const *TYPE_NAMES[Log::kTypeCount] = {
+    "info",
+    "connect",
+    "disconnect",
+    "player_spawn",
+    "player_spawn_dev",
+    "chat",
+    "invalid_packet",
+    "dropped",
+    "slow_tick"
+};
+
+//lines per second, 0 is unlimited
+static uint32_t const RATE_LIMITS[Log::kTypeCount] = {
+    0,
+    100,
+    100,
+    50,
+    50,
+    50,
+    5,
+    20,
+    5
+};
+
+struct Record {
+    Log::Type type;
+    char const *game;
+    EntityID entity;
+    double value;
+    uint8_t name_len;
+    uint16_t text_len;
+    char name[NAME_CAPACITY];
+    char text[TEXT_CAPACITY];
+};
+
+struct RateLimiter {
+    std::atomic<uint32_t> second;
+    std::atomic<uint32_t> count;
+    std::atomic<uint32_t> suppressed;
+};
+
+static RateLimiter limiters[Log::kTypeCount];
+
+//copies at most capacity bytes without splitting a utf-8 sequence
+static uint32_t _copy(char *dst, std::string_view src, uint32_t capacity) {
+    uint32_t len = std::min<uint32_t>(src.size(), capacity);
+    if (len < src.size())
+        while (len > 0 && (static_cast<uint8_t>(src[len]) & 0xC0) == 0x80) --len;
+    std::memcpy(dst, src.data(), len);
+    return len;
+}
+
+static void _print(Record const &record) {
+    if (record.type == Log::kInfo) {
+        std::printf("%.*s\n", record.text_len, record.text);
+        return;
+    }
+    std::printf("%s", TYPE_NAMES[record.type]);
+    if (record.game != nullptr) std::printf(" game=%s", record.game);
+    if (!record.entity.null()) std::printf(" entity=%u:%u", +record.entity.hash, +record.entity.id);
+    if (record.name_len > 0) std::printf(" name=\"%.*s\"", record.name_len, record.name);
+    if (record.value != 0) std::printf(" value=%g", record.value);
+    if (record.text_len > 0) std::printf(" text=\"%.*s\"", record.text_len, record.text);
+    std::printf("\n");
+}
+
+static void _print_suppressed() {
+    for (uint32_t i = 0; i < Log::kTypeCount; ++i) {
+        uint32_t const suppressed = limiters[i].suppressed.exchange(0, std::memory_order_relaxed);
+        if (suppressed > 0) std::printf("suppressed %u %s lines\n", suppressed, TYPE_NAMES[i]);
+    }
+}
+
+static bool _allow(Log::Type type) {
+    if (RATE_LIMITS[type] == 0) return true;
+    using namespace std::chrono;
+    uint32_t const now = duration_cast<seconds>(steady_clock::now().time_since_epoch()).count();
+    RateLimiter &limiter = limiters[type];
+    //racing writers may both reset the window, which only lets a few extra lines through
+    if (limiter.second.load(std::memory_order_relaxed) != now) {
+        limiter.second.store(now, std::memory_order_relaxed);
+        limiter.count.store(0, std::memory_order_relaxed);
+    }
+    if (limiter.count.fetch_add(1, std::memory_order_relaxed) < RATE_LIMITS[type]) return true;
+    limiter.suppressed.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+static void _fill(Record &record, Log::Type type, Log::Fields const &fields) {
+    record.type = type;
+    record.game = fields.game;
+    record.entity = fields.entity;
+    record.value = fields.value;
+    record.name_len = _copy(record.name, fields.name, NAME_CAPACITY);
+    record.text_len = _copy(record.text, fields.text, TEXT_CAPACITY);
+}
+
+#ifdef WASM_SERVER
+//no threads to flush from, print in place
+void Log::write(Type type, Fields const &fields) {
+    if (!_allow(type)) return;
+    static Record record;
+    _fill(record, type, fields);
+    _print_suppressed();
+    _print(record);
+    std::fflush(stdout);
+}
+
+void Log::flush() {
+    _print_suppressed();
+    std::fflush(stdout);
+}
+#else
+//bounded multi producer ring, a slot's sequence tells whose turn it is:
+//equal to the position when free, position + 1 once written
+struct Slot {
+    std::atomic<uint64_t> sequence;
+    Record record;
+};
+
+static Slot ring[RING_SIZE];
+static std::atomic<uint64_t> head = 0;
+static std::atomic<uint64_t> tail = 0;
+//lines printed and flushed to stdout
+static std::atomic<uint64_t> flushed = 0;
+static std::atomic<uint32_t> overflowed = 0;
+
+static bool _pop(Record &record) {
+    uint64_t const pos = tail.load(std::memory_order_relaxed);
+    Slot &slot = ring[pos % RING_SIZE];
+    if (slot.sequence.load(std::memory_order_acquire) != pos + 1) return false;
+    record = slot.record;
+    slot.sequence.store(pos + RING_SIZE, std::memory_order_release);
+    tail.store(pos + 1, std::memory_order_relaxed);
+    return true;
+}
+
+static void _flusher() {
+    Record record;
+    while (1) {
+        bool printed = false;
+        while (_pop(record)) {
+            _print(record);
+            printed = true;
+        }
+        _print_suppressed();
+        uint32_t const lost = overflowed.exchange(0, std::memory_order_relaxed);
+        if (lost > 0) std::printf("log ring full, lost %u lines\n", lost);
+        if (printed || lost > 0) std::fflush(stdout);
+        flushed.store(tail.load(std::memory_order_relaxed), std::memory_order_release);
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+}
+
+static void _start() {
+    static std::once_flag started;
+    std::call_once(started, [](){
+        for (uint32_t i = 0; i < RING_SIZE; ++i)
+            ring[i].sequence.store(i, std::memory_order_relaxed);
+        std::thread(_flusher).detach();
+    });
+}
+
+void Log::write(Type type, Fields const &fields) {
+    if (!_allow(type)) return;
+    _start();
+    uint64_t pos = head.load(std::memory_order_relaxed);
+    while (1) {
+        Slot &slot = ring[pos % RING_SIZE];
+        int64_t const diff = slot.sequence.load(std::memory_order_acquire) - pos;
+        if (diff == 0) {
+            if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+        } else if (diff < 0) {
+            //the flusher is a whole ring behind, drop rather than wait
+            overflowed.fetch_add(1, std::memory_order_relaxed);
+            return;
+        } else
+            pos = head.load(std::memory_order_relaxed);
+    }
+    Slot &slot = ring[pos % RING_SIZE];
+    _fill(slot.record, type, fields);
+    slot.sequence.store(pos + 1, std::memory_order_release);
+}
+
+void Log::flush() {
+    _start();
+    uint64_t const target = head.load(std::memory_order_relaxed);
+    while (flushed.load(std::memory_order_acquire) < target)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+}
+#endif
+
+void Log::info(std::string_view text) {
+    write(kInfo, { .text = text });
+}
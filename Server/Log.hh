@@ -0,0 +1,38 @@
+#pragma once
+
+#include <Shared/Entity.hh>
+
+#include <cstdint>
+#include <string_view>
+
+//event log for the server, lines are copied into a fixed ring and
+//printed by a background thread so the tick and socket threads never block on stdout
+namespace Log {
+    enum Type : uint8_t {
+        kInfo,
+        kConnect,
+        kDisconnect,
+        kSpawn,
+        kDevSpawn,
+        kChat,
+        kInvalidPacket,
+        kDropped,
+        kSlowTick,
+        kTypeCount
+    };
+
+    struct Fields {
+        //static string, usually GameInstance::get_name()
+        char const *game = nullptr;
+        EntityID entity = NULL_ENTITY;
+        std::string_view name = {};
+        std::string_view text = {};
+        double value = 0;
+    };
+
+    //lines past a type's per second limit are counted and reported instead
+    void write(Type, Fields const &);
+    void info(std::string_view);
+    //waits for the flusher to print everything written so far
+    void flush();
+}
@@ -1,4 +1,5 @@
 #include <Shared/Simulation.hh>
+#include <Server/Scheduler.hh>
 #include <Server/Server.hh>
 
 #include <iostream>
@@ -8,7 +9,11 @@ int main() {
     std::cout << "  Simulation Size: " << sizeof(Simulation) << '\n';
     std::cout << "  Spatial Hash Size: " << sizeof(SpatialHash) << '\n';
     std::cout << "  Entity Size: " << sizeof(Entity) << '\n';
+    #define POOLED(component) std::cout << "  " #component " Block Size: " << sizeof(component##Block) << '\n';
+    PERPOOLED
+    #undef POOLED
     std::cout << "}\n";
+    TICK_SCHEDULER.print_graph();
     srand(std::time(0));
     Server::init();
     return 0;
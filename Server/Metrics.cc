@@ -0,0 +1,109 @@
+#include <Server/Metrics.hh>
+
+#include <Server/Game.hh>
+#include <Server/PetalTracker.hh>
+#include <Server/Server.hh>
+#include <Server/SpatialHash.hh>
+#include <Server/StringTable.hh>
+
+#include <Shared/Simulation.hh>
+
+#include <algorithm>
+#include <sstream>
+#include <vector>
+
+static char const *COMPONENT_NAMES[] = {
+    #define COMPONENT(name) #name,
+    PERCOMPONENT
+    #undef COMPONENT
+};
+
+//tick times and drops are written and scraped on the socket thread
+static std::vector<float> tick_times(60 * TPS, 0);
+static uint32_t tick_times_at = 0;
+static uint64_t tick_count = 0;
+static double tick_seconds_total = 0;
+static uint64_t dropped_total = 0;
+
+void Metrics::GameMetrics::sample(Simulation *sim, uint32_t client_count, uint32_t bytes) {
+    clients.store(client_count, std::memory_order_relaxed);
+    tick_bytes.store(bytes, std::memory_order_relaxed);
+    bytes_total.fetch_add(bytes, std::memory_order_relaxed);
+    if (ticks++ % TPS != 0) return;
+    std::array<uint32_t, kComponentCount> counts = {};
+    uint32_t entities = 0;
+    sim->for_each_entity([&](Simulation *, Entity &ent) {
+        ++entities;
+        for (uint32_t i = 0; i < kComponentCount; ++i)
+            counts[i] += ent.has_component(i);
+    });
+    entity_count.store(entities, std::memory_order_relaxed);
+    for (uint32_t i = 0; i < kComponentCount; ++i)
+        component_counts[i].store(counts[i], std::memory_order_relaxed);
+    SpatialHash::Occupancy occupancy = sim->spatial_hash.get_occupancy();
+    hash_cells_occupied.store(occupancy.occupied_cells, std::memory_order_relaxed);
+    hash_max_cell.store(occupancy.max_cell, std::memory_order_relaxed);
+    hash_entries.store(occupancy.entries, std::memory_order_relaxed);
+}
+
+void Metrics::record_tick(double ms) {
+    tick_times[tick_times_at] = ms / 1000;
+    tick_times_at = (tick_times_at + 1) % tick_times.size();
+    ++tick_count;
+    tick_seconds_total += ms / 1000;
+}
+
+void Metrics::record_dropped() {
+    ++dropped_total;
+}
+
+template<typename T>
+static void _write_per_game(std::ostringstream &out, char const *name, char const *type, char const *help, T get) {
+    out << "# HELP " << name << ' ' << help << "\n# TYPE " << name << ' ' << type << '\n';
+    for (GameInstance const &game : Server::games)
+        out << name << "{gamemode=\"" << game.get_name() << "\"} " << get(game.metrics) << '\n';
+}
+
+std::string Metrics::render() {
+    std::ostringstream out;
+    std::vector<float> sorted(tick_times.begin(), tick_times.begin() + std::min<uint64_t>(tick_count, tick_times.size()));
+    std::sort(sorted.begin(), sorted.end());
+    out << "# HELP gardn_tick_seconds Server tick duration over the last minute\n# TYPE gardn_tick_seconds summary\n";
+    for (double q : { 0.5, 0.9, 0.99, 1.0 })
+        out << "gardn_tick_seconds{quantile=\"" << q << "\"} " << (sorted.empty() ? 0 : sorted[(sorted.size() - 1) * q]) << '\n';
+    out << "gardn_tick_seconds_sum " << tick_seconds_total << '\n';
+    out << "gardn_tick_seconds_count " << tick_count << '\n';
+    out << "# HELP gardn_dropped_total Clients closed for exceeding the backpressure limit\n# TYPE gardn_dropped_total counter\n";
+    out << "gardn_dropped_total " << dropped_total << '\n';
+    out << "# HELP gardn_players Connected players across all games\n# TYPE gardn_players gauge\n";
+    out << "gardn_players " << Server::get_player_count() << '\n';
+    out << "# HELP gardn_interned_strings Names and chat lines in the string table\n# TYPE gardn_interned_strings gauge\n";
+    out << "gardn_interned_strings " << InternedString::count() << '\n';
+
+    auto load = [](auto const &v) { return v.load(std::memory_order_relaxed); };
+    _write_per_game(out, "gardn_clients", "gauge", "Clients per game",
+        [&](GameMetrics const &m) { return load(m.clients); });
+    _write_per_game(out, "gardn_tick_bytes", "gauge", "Bytes queued to clients on the last tick",
+        [&](GameMetrics const &m) { return load(m.tick_bytes); });
+    _write_per_game(out, "gardn_bytes_sent_total", "counter", "Bytes queued to clients",
+        [&](GameMetrics const &m) { return load(m.bytes_total); });
+    _write_per_game(out, "gardn_entity_count", "gauge", "Allocated entities",
+        [&](GameMetrics const &m) { return load(m.entity_count); });
+    _write_per_game(out, "gardn_spatial_hash_occupied_cells", "gauge", "Spatial hash cells holding at least one entity",
+        [&](GameMetrics const &m) { return load(m.hash_cells_occupied); });
+    _write_per_game(out, "gardn_spatial_hash_max_cell", "gauge", "Entries in the fullest spatial hash cell",
+        [&](GameMetrics const &m) { return load(m.hash_max_cell); });
+    _write_per_game(out, "gardn_spatial_hash_entries", "gauge", "Entries across all spatial hash cells",
+        [&](GameMetrics const &m) { return load(m.hash_entries); });
+
+    out << "# HELP gardn_component_count Entities with a component\n# TYPE gardn_component_count gauge\n";
+    for (GameInstance const &game : Server::games)
+        for (uint32_t i = 0; i < kComponentCount; ++i)
+            out << "gardn_component_count{gamemode=\"" << game.get_name() << "\",component=\""
+                << COMPONENT_NAMES[i] << "\"} " << load(game.metrics.component_counts[i]) << '\n';
+
+    out << "# HELP gardn_petal_count Petals tracked by PetalTracker\n# TYPE gardn_petal_count gauge\n";
+    for (PetalID::T id = PetalID::kBasic; id < PetalID::kNumPetals; ++id)
+        out << "gardn_petal_count{petal=\"" << PETAL_DATA[id].name << "\"} " << PetalTracker::get_count(id) << '\n';
+    return out.str();
+}
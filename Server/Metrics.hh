@@ -0,0 +1,34 @@
+#pragma once
+
+#include <Shared/Entity.hh>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+class Simulation;
+
+//prometheus text exposition for the native server's /metrics route
+//games publish into atomics from their own thread, scrapes only read them
+namespace Metrics {
+    class GameMetrics {
+        //only touched by the game's thread
+        uint32_t ticks = 0;
+    public:
+        std::atomic<uint32_t> clients = 0;
+        std::atomic<uint32_t> tick_bytes = 0;
+        std::atomic<uint64_t> bytes_total = 0;
+        std::atomic<uint32_t> entity_count = 0;
+        std::array<std::atomic<uint32_t>, kComponentCount> component_counts = {};
+        std::atomic<uint32_t> hash_cells_occupied = 0;
+        std::atomic<uint32_t> hash_max_cell = 0;
+        std::atomic<uint32_t> hash_entries = 0;
+        //called at the end of every tick, the full entity walk runs once per second
+        void sample(Simulation *, uint32_t, uint32_t);
+    };
+
+    void record_tick(double);
+    void record_dropped();
+    std::string render();
+}
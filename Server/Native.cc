@@ -2,6 +2,11 @@
 #include <Server/Server.hh>
 
 #include <Server/Client.hh>
+#include <Server/Journal.hh>
+#include <Server/Log.hh>
+#include <Server/Metrics.hh>
+#include <Server/Snapshot.hh>
+#include <Server/Trace.hh>
 #include <Shared/Config.hh>
 
 static us_listen_socket_t *socket;
@@ -21,21 +26,24 @@ static uWS::App make_server() {
         /* Handlers */
         .upgrade = nullptr,
         .open = [](WebSocket *ws) {
-            std::cout << "client connection\n";
+            Log::write(Log::kConnect, {});
             connections.insert(ws);
             Client *client = ws->getUserData();
             client->ws = ws;
+            Journal::record_connect(client);
         },
         .message = [](WebSocket *ws, std::string_view message, uWS::OpCode opCode) {
             Client::on_message(ws, message, opCode);
         },
         .dropped = [](WebSocket *ws, std::string_view /*message*/, uWS::OpCode /*opCode*/) {
-            std::cout << "dropped packet\n";
+            Log::write(Log::kDropped, {});
+            Metrics::record_dropped();
             Client *client = ws->getUserData();
             if (client == nullptr) {
                 ws->end(1006, "Dropped Message");
                 return;
             }
+            Journal::record_disconnect(client, 1006);
             client->disconnect();
             /* A message was dropped due to set maxBackpressure and closeOnBackpressureLimit limit */
         },
@@ -47,10 +55,13 @@ static uWS::App make_server() {
             Client::on_disconnect(ws, code, message);
             connections.erase(ws);
         }
+    }).get("/metrics", [](auto *res, auto */*req*/) {
+        //served between ticks on the socket thread, only reads published atomics
+        res->writeHeader("Content-Type", "text/plain; version=0.0.4")->end(Metrics::render());
     }).listen(SERVER_PORT, [](auto *listen_socket) {
         assert(listen_socket);
         socket = listen_socket;
-        std::cout << "Listening on port " << SERVER_PORT << std::endl;
+        Log::info("Listening on port " + std::to_string(SERVER_PORT));
     });
 }
 
@@ -62,11 +73,20 @@ void Server::init() {
     sigemptyset(&sa.sa_mask);
     sa.sa_flags = SA_RESTART;
     assert(sigaction(SIGUSR2, &sa, nullptr) == 0);
+    sa.sa_handler = [](int signum){
+        Trace::request();
+    };
+    assert(sigaction(SIGUSR1, &sa, nullptr) == 0);
     std::atexit([](){
-        std::cout << "exiting...\n";
+        Log::info("exiting...");
+        Log::flush();
     });
 
-    for (GameInstance &game : Server::games) game.init();
+    bool const warm_start = Snapshot::init_games() > 0;
+    for (GameInstance &game : Server::games)
+        game.start_worker();
+    Journal::init(warm_start);
+    Trace::init();
     Server::run();
 }
 
@@ -81,7 +101,7 @@ void Server::run() {
 
 void Server::stop() {
     Server::is_stopping = true;
-    std::cout << "stopping...\n";
+    Log::info("stopping...");
     us_listen_socket_close(0, socket);
     std::vector<WebSocket *> to_close(connections.begin(), connections.end());
     for (WebSocket *ws : to_close)
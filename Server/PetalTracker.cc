@@ -4,22 +4,46 @@
 
 #include <Shared/Simulation.hh>
 
+#include <array>
+
 using namespace PetalTracker;
 
-void PetalTracker::add_petal(PetalID::T id) {
+//a unique petal nobody holds may only be handed out by one game per tick, picked in turn
+//at the join point, so grants never race between game threads and replay the same way
+static std::array<Simulation const *, PetalID::kNumPetals> unique_grantee = {};
+static uint32_t grant_turn = 0;
+
+void PetalTracker::add_petal(Simulation *sim, PetalID::T id) {
     DEBUG_ONLY(assert(id < PetalID::kNumPetals);)
     if (id == PetalID::kNone) return;
-    ++Server::petal_count_tracker[id];
+    sim->petal_counts[id].fetch_add(1, std::memory_order_relaxed);
 }
 
-void PetalTracker::remove_petal(PetalID::T id) {
+void PetalTracker::remove_petal(Simulation *sim, PetalID::T id) {
     DEBUG_ONLY(assert(id < PetalID::kNumPetals);)
     if (id == PetalID::kNone) return;
-    --Server::petal_count_tracker[id];
+    sim->petal_counts[id].fetch_sub(1, std::memory_order_relaxed);
 }
 
 uint32_t PetalTracker::get_count(PetalID::T id) {
     DEBUG_ONLY(assert(id < PetalID::kNumPetals);)
     if (id == PetalID::kNone) return 0;
-    return Server::petal_count_tracker[id];
+    uint32_t count = 0;
+    for (GameInstance const &game : Server::games)
+        count += game.simulation.petal_counts[id].load(std::memory_order_relaxed);
+    return count;
+}
+
+void PetalTracker::end_tick() {
+    Simulation const *turn = &Server::games[grant_turn++ % Server::games.size()].simulation;
+    for (PetalID::T id = PetalID::kBasic; id < PetalID::kNumPetals; ++id) {
+        if (PETAL_DATA[id].rarity != RarityID::kUnique) continue;
+        unique_grantee[id] = get_count(id) == 0 ? turn : nullptr;
+    }
+}
+
+bool PetalTracker::can_grant_unique(Simulation *sim, PetalID::T id) {
+    DEBUG_ONLY(assert(id < PetalID::kNumPetals);)
+    //the game's own count covers grants made earlier in the same tick
+    return unique_grantee[id] == sim && sim->petal_counts[id].load(std::memory_order_relaxed) == 0;
 }
@@ -5,7 +5,12 @@
 class Simulation;
 
 namespace PetalTracker {
-    void add_petal(PetalID::T);
-    void remove_petal(PetalID::T);
+    void add_petal(Simulation *, PetalID::T);
+    void remove_petal(Simulation *, PetalID::T);
+    //summed over every game, only exact between ticks
     uint32_t get_count(PetalID::T);
+    //called at the join point after every game has ticked
+    void end_tick();
+    //whether this game may hand out the unique petal id this tick
+    bool can_grant_unique(Simulation *, PetalID::T);
 }
\ No newline at end of file
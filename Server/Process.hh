@@ -1,17 +1,34 @@
 #pragma once
 
+#include <cstdint>
+
 class Simulation;
 class Entity;
 
+//idle mobs think every AI_IDLE_THINK_PERIOD ticks, and at most
+//AI_IDLE_THINK_BUDGET of them think in one tick, the rest wait their turn
+//mobs within AI_THINK_NEAR_RADIUS of a camera count their wait in full
+inline uint32_t const AI_IDLE_THINK_PERIOD = 4;
+inline uint32_t const AI_IDLE_THINK_BUDGET = 256;
+inline float const AI_THINK_NEAR_RADIUS = 500;
+
 void tick_ai_behavior(Simulation *, Entity &);
+void tick_ai_think_budget(Simulation *);
 void tick_camera_behavior(Simulation *, Entity &);
 void tick_chat_behavior(Simulation *, Entity &);
 void tick_curse_behavior(Simulation *);
 void tick_culling_behavior(Simulation *, Entity &);
+void tick_dormancy(Simulation *);
 void tick_drop_behavior(Simulation *, Entity &);
 void tick_entity_motion(Simulation *, Entity &);
 void tick_health_behavior(Simulation *, Entity &);
+#ifdef DEAD_RECKONING
+void tick_mob_reckoning(Simulation *, Entity &);
+#endif
 void tick_petal_behavior(Simulation *, Entity &);
+#ifdef ORBIT_PREDICTION
+void tick_petal_orbit(Simulation *, Entity &);
+#endif
 void tick_player_behavior(Simulation *, Entity &);
 void tick_player_ai_behavior(Simulation *, Entity &);
 void tick_segment_behavior(Simulation *, Entity &);
@@ -6,7 +6,10 @@
 #include <Shared/Simulation.hh>
 #include <Shared/StaticData.hh>
 
+#include <algorithm>
 #include <cmath>
+#include <limits>
+#include <vector>
 
 static void _focus_lose_clause(Entity &ent, Vector const &v) {
     if (v.magnitude() > 1.5 * ent.detection_radius) ent.target = NULL_ENTITY;
@@ -359,10 +362,65 @@ static void tick_digger(Simulation *sim, Entity &ent) {
     }
 }
 
+//0 for mobs that never move on their own, AI_IDLE_THINK_PERIOD for idle mobs
+//that only wander around, 1 for everything engaged or with per tick behavior
+static uint8_t _think_period(Simulation *sim, Entity const &ent) {
+    switch(ent.get_mob_id()) {
+        case MobID::kBoulder:
+        case MobID::kRock:
+        case MobID::kCactus:
+        case MobID::kSquare:
+            return 0;
+        case MobID::kBabyAnt:
+        case MobID::kLadybug:
+        case MobID::kMassiveLadybug:
+        case MobID::kWorkerAnt:
+        case MobID::kDarkLadybug:
+        case MobID::kShinyLadybug:
+        case MobID::kSoldierAnt:
+        case MobID::kFireAnt:
+        case MobID::kBeetle:
+        case MobID::kMassiveBeetle:
+        case MobID::kScorpion:
+            if (sim->ent_alive(ent.target) || sim->ent_alive(ent.get_parent())) return 1;
+            if (ent.ai_state == AIState::kReturning) return 1;
+            return AI_IDLE_THINK_PERIOD;
+        default:
+            return 1;
+    }
+}
+
+//due idle mobs are ranked by how long they have waited past their think, scaled down
+//with distance to the nearest camera, so the budget rotates through every mob and a
+//mob next to a player is served before one at the edge of the screen
+void tick_ai_think_budget(Simulation *sim) {
+    struct Due { float priority; EntityID id; };
+    static thread_local std::vector<Due> due;
+    due.clear();
+    sim->for_each<kMob>([](Simulation *sim, Entity &ent) {
+        BitMath::unset(ent.flags, EntityFlags::kThinkGranted);
+        if (ent.pending_delete) return;
+        if (BitMath::at(ent.flags, EntityFlags::kIsDormant)) return;
+        if (BitMath::at(ent.flags, EntityFlags::kIsCulled)) return;
+        uint8_t const period = _think_period(sim, ent);
+        if (period <= 1 || ent.ai_ticks_since_think + 1 < period) return;
+        float const waited = ent.ai_ticks_since_think + 2 - period;
+        float const distance = std::max(ent.ai_camera_distance, AI_THINK_NEAR_RADIUS);
+        due.push_back({ waited * AI_THINK_NEAR_RADIUS / distance, ent.id });
+    });
+    auto const before = [](Due const &a, Due const &b) {
+        if (a.priority != b.priority) return a.priority > b.priority;
+        return a.id.id < b.id.id;
+    };
+    if (due.size() > AI_IDLE_THINK_BUDGET)
+        std::nth_element(due.begin(), due.begin() + AI_IDLE_THINK_BUDGET, due.end(), before);
+    for (uint32_t i = 0; i < due.size() && i < AI_IDLE_THINK_BUDGET; ++i)
+        BitMath::set(sim->get_ent(due[i].id).flags, EntityFlags::kThinkGranted);
+}
+
 void tick_ai_behavior(Simulation *sim, Entity &ent) {
     if (ent.pending_delete) return;
     if (ent.has_component(kSegmented) && sim->ent_alive(ent.get_seg_head())) return;
-    ent.acceleration.set(0,0);
     if (!(ent.get_parent() == NULL_ENTITY)) {
         if (!sim->ent_alive(ent.get_parent())) {
             if (BitMath::at(ent.flags, EntityFlags::kDieOnParentDeath))
@@ -386,10 +444,37 @@ void tick_ai_behavior(Simulation *sim, Entity &ent) {
         }
     }
     if (BitMath::at(ent.flags, EntityFlags::kIsCulled)) {
+        ent.acceleration.set(0,0);
+        ent.ai_acceleration_step.set(0,0);
         ent.target = NULL_ENTITY;
         ent.ai_tick = 0;
         return;
     }
+    ent.ai_think_period = _think_period(sim, ent);
+    if (ent.ai_think_period == 0) {
+        ent.acceleration.set(0,0);
+        return;
+    }
+    //between idle thinks, ease from the last think's acceleration to this one's
+    if (ent.ai_think_period > 1) {
+        if (ent.ai_ticks_since_think < std::numeric_limits<game_tick_t>::max())
+            ++ent.ai_ticks_since_think;
+        if (ent.ai_ticks_since_think < ent.ai_think_period) {
+            ent.acceleration += ent.ai_acceleration_step;
+            return;
+        }
+        //over budget, slow down rather than keep pushing blind until the next think
+        if (!BitMath::at(ent.flags, EntityFlags::kThinkGranted)) {
+            ent.acceleration *= 0.5;
+            ent.ai_acceleration_step.set(0,0);
+            return;
+        }
+    } else
+        ent.ai_ticks_since_think = 1;
+    game_tick_t const elapsed = ent.ai_ticks_since_think;
+    ent.ai_ticks_since_think = 0;
+    Vector const last_acceleration = ent.acceleration;
+    ent.acceleration.set(0,0);
     if (!sim->ent_alive(ent.target) && sim->ent_exists(ent.target)) {
         Entity &target = sim->get_ent(ent.target);
         if (sim->ent_alive(target.get_parent())) {
@@ -493,5 +578,11 @@ void tick_ai_behavior(Simulation *sim, Entity &ent) {
         if (ent.get_y() + ent.get_radius() >= ARENA_HEIGHT && angle_within(ent.get_angle(), M_PI / 2, M_PI / 2))
             ent.set_angle(0 - ent.get_angle());
     }
-    ++ent.ai_tick;
+    ent.ai_tick += elapsed;
+    //stopping is not eased, an idle mob that is done moving stops right away
+    if (ent.ai_think_period > 1 && (ent.acceleration.x != 0 || ent.acceleration.y != 0)) {
+        ent.ai_acceleration_step = (ent.acceleration - last_acceleration) * (1.0f / ent.ai_think_period);
+        ent.acceleration = last_acceleration + ent.ai_acceleration_step;
+    } else
+        ent.ai_acceleration_step.set(0,0);
 }
\ No newline at end of file
@@ -5,10 +5,56 @@
 #include <Shared/Simulation.hh>
 #include <Shared/StaticData.hh>
 
+#include <algorithm>
+
 constexpr float CULL_EXTRA_RADIUS = 250;
 
-void tick_culling_behavior(Simulation *sim, Entity &ent) {
-    sim->spatial_hash.query(ent.get_camera_x(), ent.get_camera_y(), 960 / ent.get_fov() + CULL_EXTRA_RADIUS, 540 / ent.get_fov() + CULL_EXTRA_RADIUS, [](Simulation *, Entity &ent) {
+//the arena is split into square regions, and a region stays awake while it overlaps
+//any camera's culling rectangle grown by one more region, so a mob is always awake
+//well before it can be unculled or seen
+constexpr uint32_t DORMANCY_REGION_SIZE = 1000;
+constexpr uint32_t DORMANCY_REGIONS_X = div_round_up(ARENA_WIDTH, DORMANCY_REGION_SIZE);
+constexpr uint32_t DORMANCY_REGIONS_Y = div_round_up(ARENA_HEIGHT, DORMANCY_REGION_SIZE);
+
+static uint32_t _region_index(float x, float y) {
+    uint32_t const rx = std::clamp<float>(x / DORMANCY_REGION_SIZE, 0, DORMANCY_REGIONS_X - 1);
+    uint32_t const ry = std::clamp<float>(y / DORMANCY_REGION_SIZE, 0, DORMANCY_REGIONS_Y - 1);
+    return ry * DORMANCY_REGIONS_X + rx;
+}
+
+void tick_culling_behavior(Simulation *sim, Entity &camera) {
+    sim->spatial_hash.query(camera.get_camera_x(), camera.get_camera_y(), 960 / camera.get_fov() + CULL_EXTRA_RADIUS, 540 / camera.get_fov() + CULL_EXTRA_RADIUS, [&](Simulation *, Entity &ent) {
         BitMath::unset(ent.flags, EntityFlags::kIsCulled);
+        //idle thinks go to mobs nearest a player first
+        Vector const delta(ent.get_x() - camera.get_camera_x(), ent.get_y() - camera.get_camera_y());
+        ent.ai_camera_distance = std::min(ent.ai_camera_distance, delta.magnitude());
+    });
+}
+
+//only wild mobs go dormant, anything a player owns or summoned stays near them anyway
+//dormant mobs are left out of the spatial hash and every awake_only system
+//wakes only depend on camera positions, so they happen on the same tick in a replay
+void tick_dormancy(Simulation *sim) {
+    std::array<uint8_t, div_round_up(DORMANCY_REGIONS_X * DORMANCY_REGIONS_Y, 8)> awake = {};
+    sim->for_each<kCamera>([&](Simulation *, Entity &camera) {
+        float const half_w = 960 / camera.get_fov() + CULL_EXTRA_RADIUS + DORMANCY_REGION_SIZE;
+        float const half_h = 540 / camera.get_fov() + CULL_EXTRA_RADIUS + DORMANCY_REGION_SIZE;
+        uint32_t const top_left = _region_index(camera.get_camera_x() - half_w, camera.get_camera_y() - half_h);
+        uint32_t const bottom_right = _region_index(camera.get_camera_x() + half_w, camera.get_camera_y() + half_h);
+        for (uint32_t ry = top_left / DORMANCY_REGIONS_X; ry <= bottom_right / DORMANCY_REGIONS_X; ++ry)
+            for (uint32_t rx = top_left % DORMANCY_REGIONS_X; rx <= bottom_right % DORMANCY_REGIONS_X; ++rx)
+                BitMath::set_arr(awake.data(), ry * DORMANCY_REGIONS_X + rx);
+    });
+    sim->for_each<kMob>([&](Simulation *, Entity &ent) {
+        if (!BitMath::at(ent.flags, EntityFlags::kSpawnedFromZone)) return;
+        if (BitMath::at_arr(awake.data(), _region_index(ent.get_x(), ent.get_y()))) {
+            BitMath::unset(ent.flags, EntityFlags::kIsDormant);
+            return;
+        }
+        if (BitMath::at(ent.flags, EntityFlags::kIsDormant)) return;
+        //frozen in place, not drifting off on the velocity it fell asleep with
+        BitMath::set(ent.flags, EntityFlags::kIsDormant);
+        ent.velocity.set(0, 0);
+        ent.target = NULL_ENTITY;
     });
 }
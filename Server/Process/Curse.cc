@@ -7,6 +7,19 @@
 
 #include <Shared/StaticData.hh>
 
+#include <algorithm>
+
+//mobs are lured from twice their detection radius, none from further away than this
+static float _max_lure_radius() {
+    static float const radius = [](){
+        float max_radius = 0;
+        for (MobData const &data : MOB_DATA)
+            max_radius = std::max(max_radius, data.attributes.aggro_radius);
+        return max_radius * 2;
+    }();
+    return radius;
+}
+
 void tick_curse_behavior(Simulation *sim) {
     EntityID &leader_dot = sim->arena_info.leader_dot;
     EntityID old_leader_dot = leader_dot;
@@ -18,25 +31,25 @@ void tick_curse_behavior(Simulation *sim) {
             leader_dots.pop_back();
         }
     }
-    EntityID leader = NULL_ENTITY;
-    uint32_t max_score = level_to_score(60);
-    sim->for_each<kCamera>([&](Simulation *sim, Entity &ent) {
-        if (!sim->ent_alive(ent.get_player())) return;
-        uint32_t score = sim->get_ent(ent.get_player()).get_score();
-        if (score <= max_score) return;
-        max_score = score;
-        leader = ent.get_player();
-    });
+    //the leaderboard runs at the end of the tick, so this is last tick's ranking
+    EntityID leader = sim->leaderboard.leader();
+    uint32_t max_score = 0;
+    if (sim->ent_alive(leader)) max_score = sim->get_ent(leader).get_score();
+    if (max_score <= level_to_score(60)) leader = NULL_ENTITY;
     if (sim->ent_alive(leader)) {
         Entity &player = sim->get_ent(leader);
-        sim->for_each<kMob>([&](Simulation *sim, Entity &ent) {
-            if (!(ent.get_team() == NULL_ENTITY)) return;
-            if (MOB_DATA[ent.get_mob_id()].attributes.hole) return;
-            if (sim->ent_alive(ent.target)) return;
-            Vector delta(player.get_x() - ent.get_x(), player.get_y() - ent.get_y());
-            if (delta.magnitude() > ent.detection_radius * 2) return;
-            ent.target = leader;
-        });
+        //idle mobs only look around every AI_IDLE_THINK_PERIOD ticks, the lure does not need to be faster
+        if (player.lifetime % AI_IDLE_THINK_PERIOD == 0) {
+            float const radius = _max_lure_radius();
+            sim->threat_grid.query_wild(player.get_x(), player.get_y(), radius, radius, [&](Simulation *sim, Entity &ent) {
+                if (!ent.has_component(kMob) || ent.pending_delete) return;
+                if (MOB_DATA[ent.get_mob_id()].attributes.hole) return;
+                if (sim->ent_alive(ent.target)) return;
+                Vector delta(player.get_x() - ent.get_x(), player.get_y() - ent.get_y());
+                if (delta.magnitude() > ent.detection_radius * 2) return;
+                ent.target = leader;
+            });
+        }
         if (max_score >= level_to_score(75)) {
             if (sim->ent_alive(old_leader_dot) && sim->get_ent(old_leader_dot).get_parent() == player.id)
                 leader_dot = old_leader_dot;
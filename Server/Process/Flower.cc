@@ -3,6 +3,7 @@
 #include <Server/EntityFunctions.hh>
 #include <Server/Spawn.hh>
 #include <Shared/Entity.hh>
+#include <Shared/Orbit.hh>
 #include <Shared/Simulation.hh>
 #include <Shared/StaticData.hh>
 
@@ -30,53 +31,37 @@ struct RotationCenter {
     float r;
 };
 
+//the loadout's part is cached in its summary, only input and the player's own fields are per tick
 static struct PlayerBuffs _get_petal_passive_buffs(Simulation *sim, Entity &player) {
     struct PlayerBuffs buffs = {0};
     if (player.has_component(kMob)) return buffs;
-    player.set_equip_flags(0);
-    player.damage_reflection = 0;
-    player.poison_armor = 0;
-    if (player.get_overlevel_timer() >= PETAL_DISABLE_DELAY * TPS) return buffs;
-    for (uint32_t i = 0; i < player.get_loadout_count(); ++i) {
-        LoadoutSlot const &slot = player.loadout[i];
-        PetalID::T slot_petal_id = slot.get_petal_id();
-        struct PetalData const &petal_data = PETAL_DATA[slot_petal_id];
-        struct PetalAttributes const &attrs = petal_data.attributes;
-        if (attrs.equipment != EquipmentFlags::kNone)
-            player.set_equip_flags(player.get_equip_flags() | (1 << attrs.equipment));
-        buffs.vision_factor = std::min(buffs.vision_factor, attrs.vision_factor);
-        buffs.extra_range = std::fmax(attrs.extra_range, buffs.extra_range);
-        buffs.extra_damage = std::fmax(buffs.extra_damage, attrs.extra_body_damage);
-        buffs.damage_factor *= attrs.extra_damage_factor;
-        buffs.reload_factor *= attrs.extra_reload_factor;
-        if (slot_petal_id == PetalID::kYinYang)
-            ++buffs.yinyang_count;
-        if (!player.loadout[i].already_spawned) continue;
-        if (slot_petal_id == PetalID::kLeaf) 
-            buffs.heal += attrs.constant_heal / TPS;
-        else if (slot_petal_id == PetalID::kYucca && BitMath::at(player.input, InputFlags::kDefending) && !BitMath::at(player.input, InputFlags::kAttacking)) 
-            buffs.heal += attrs.constant_heal / TPS;
-        buffs.extra_rot += attrs.extra_rotation_speed;
-        buffs.extra_health += attrs.extra_health;
-        buffs.extra_radius += attrs.extra_radius;
-        buffs.health_factor *= attrs.health_factor;
-        player.speed_ratio *= attrs.speed_factor;
-        player.damage_reflection = std::fmax(player.damage_reflection, attrs.damage_reflection);
-        player.poison_armor = std::fmax(player.poison_armor, attrs.poison_armor / TPS);
-        if (slot_petal_id == PetalID::kPoisonCactus)
-            buffs.is_poisonous = 1;
-        if (slot_petal_id == PetalID::kGoldenLeaf) {
-            buffs.damage_factor *= 1.2;
-            buffs.reload_factor *= 1.2;
-        }
-    }
+    LoadoutSummary const &summary = get_loadout_summary(player);
+    player.set_equip_flags(summary.equip_flags);
+    player.damage_reflection = summary.damage_reflection;
+    player.poison_armor = summary.poison_armor;
+    if (summary.disabled) return buffs;
+    buffs.vision_factor = summary.vision_factor;
+    buffs.extra_range = summary.extra_range;
+    buffs.extra_damage = summary.extra_damage;
+    buffs.damage_factor = summary.damage_factor;
+    buffs.reload_factor = summary.reload_factor;
+    buffs.yinyang_count = summary.yinyang_count;
+    buffs.heal = summary.heal;
+    if (BitMath::at(player.input, InputFlags::kDefending) && !BitMath::at(player.input, InputFlags::kAttacking))
+        buffs.heal += summary.defending_heal;
+    buffs.extra_rot = summary.extra_rot;
+    buffs.extra_health = summary.extra_health;
+    buffs.extra_radius = summary.extra_radius;
+    buffs.health_factor = summary.health_factor;
+    buffs.is_poisonous = summary.is_poisonous;
+    player.speed_ratio *= summary.speed_factor;
     return buffs;
 }
 
 static uint32_t _get_petal_rotation_count(Simulation *sim, Entity &player) {
     uint32_t count = 0;
     for (uint8_t i = 0; i < player.get_loadout_count(); ++i) {
-        LoadoutSlot const &slot = player.loadout[i];
+        LoadoutSlot const &slot = player.loadout()[i];
         struct PetalData const &petal_data = PETAL_DATA[slot.get_petal_id()];
         if (petal_data.attributes.clump_radius > 0)
             ++count;
@@ -102,8 +87,31 @@ static RotationCenter const _get_petal_rotation_center(Simulation *sim, Entity c
     return rotation_center;
 }
 
+#ifdef ORBIT_PREDICTION
+//steps what clients predict for each orbiting petal, before this tick changes what they were sent
+static void _predict_orbits(Simulation *sim, Entity &player) {
+    for (uint32_t i = 0; i < player.get_loadout_count(); ++i) {
+        LoadoutSlot const &slot = player.loadout()[i];
+        for (uint32_t j = 0; j < slot.size(); ++j) {
+            if (!sim->ent_alive(slot.petals[j].ent_id)) continue;
+            Entity &petal = sim->get_ent(slot.petals[j].ent_id);
+            if (!petal.has_component(kPetal) || !BitMath::at(petal.get_petal_flags(), PetalFlags::kOrbiting)) continue;
+            Vector vel(petal.get_orbit_vx(), petal.get_orbit_vy());
+            float angle = petal.get_angle();
+            orbit_predict(player, petal, petal.orbit_pos, vel, angle);
+            petal.set_orbit_vx(vel.x);
+            petal.set_orbit_vy(vel.y);
+            petal.orbit_stepped = 1;
+        }
+    }
+}
+#endif
+
 void tick_player_behavior(Simulation *sim, Entity &player) {
     if (player.pending_delete) return;
+    #ifdef ORBIT_PREDICTION
+    _predict_orbits(sim, player);
+    #endif
     DEBUG_ONLY(assert(player.max_health > 0);)
     PlayerBuffs const buffs = _get_petal_passive_buffs(sim, player);
     float health_ratio = player.health / player.max_health;
@@ -133,11 +141,13 @@ void tick_player_behavior(Simulation *sim, Entity &player) {
 
     DEBUG_ONLY(assert(player.get_loadout_count() <= MAX_SLOT_COUNT);)
     for (uint32_t i = 0; i < player.get_loadout_count(); ++i) {
-        LoadoutSlot &slot = player.loadout[i];
+        LoadoutSlot &slot = player.loadout()[i];
         //player.set_loadout_ids(i, slot.id);
         //other way around. loadout_ids should dictate loadout
-        if (slot.get_petal_id() != player.get_loadout_ids(i) || player.get_overlevel_timer() >= PETAL_DISABLE_DELAY * TPS)
+        if (slot.get_petal_id() != player.get_loadout_ids(i) || player.get_overlevel_timer() >= PETAL_DISABLE_DELAY * TPS) {
             slot.update_id(sim, player.get_loadout_ids(i));
+            player.loadout_summary().dirty = 1;
+        }
         PetalID::T slot_petal_id = slot.get_petal_id();
         struct PetalData const &petal_data = PETAL_DATA[slot_petal_id];
         DEBUG_ONLY(assert(petal_data.count <= MAX_PETALS_IN_CLUMP);)
@@ -160,6 +170,7 @@ void tick_player_behavior(Simulation *sim, Entity &player) {
                     petal_slot.ent_id = alloc_petal(sim, slot_petal_id, player).id;
                     sim->get_ent(petal_slot.ent_id).damage *= buffs.damage_factor;
                     petal_slot.reload = 0;
+                    if (!slot.already_spawned) player.loadout_summary().dirty = 1;
                     slot.already_spawned = 1;
                 } 
                 else
@@ -197,6 +208,14 @@ void tick_player_behavior(Simulation *sim, Entity &player) {
                     wanting += delta;
                     wanting *= 0.5;
                     petal.acceleration = wanting;
+                    #ifdef ORBIT_PREDICTION
+                    //the wing's reach follows its lifetime, leave it on full updates
+                    if (petal.get_petal_id() != PetalID::kWing) {
+                        petal.set_orbit_slot(rotation_count > 0 ? 2 * M_PI * rot_pos / rotation_count : 0);
+                        petal.set_orbit_member(j);
+                        petal.orbit_driven = 1;
+                    }
+                    #endif
                     game_tick_t sec_reload_ticks = petal_data.attributes.secondary_reload * TPS;
                     if (petal_data.attributes.spawns != MobID::kNumMobs &&
                         petal.secondary_reload >= sec_reload_ticks) {
@@ -262,4 +281,14 @@ void tick_player_behavior(Simulation *sim, Entity &player) {
         }
     } else 
         player.heading_angle += 10 * rot;
+    #ifdef ORBIT_PREDICTION
+    //what next tick's rotation will use, short of input changes in between
+    float orbit_range = player.get_radius() + 40;
+    if (BitMath::at(player.input, InputFlags::kAttacking))
+        orbit_range = player.get_radius() + 100 + buffs.extra_range;
+    else if (BitMath::at(player.input, InputFlags::kDefending))
+        orbit_range = player.get_radius() + 15;
+    player.set_orbit_heading(player.heading_angle);
+    player.set_orbit_range(orbit_range);
+    #endif
 }
\ No newline at end of file
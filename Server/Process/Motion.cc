@@ -2,6 +2,7 @@
 
 #include <Shared/Simulation.hh>
 #include <Shared/Entity.hh>
+#include <Shared/Reckoning.hh>
 
 void tick_entity_motion(Simulation *sim, Entity &ent) {
     if (ent.pending_delete) return;
@@ -26,4 +27,55 @@ void tick_entity_motion(Simulation *sim, Entity &ent) {
     //ent.acceleration.set(0,0);
     ent.collision_velocity.set(0,0);
     ent.speed_ratio = 1;
-}
\ No newline at end of file
+}
+
+#ifdef DEAD_RECKONING
+//after motion: mobs that landed near where clients extrapolated them stay out of the update,
+//the rest send position and velocity, and acceleration goes out whenever the AI steered differently
+void tick_mob_reckoning(Simulation *sim, Entity &ent) {
+    //segments are pulled along by the segment ahead, not their own motion
+    if (ent.has_component(kSegmented)) return;
+    Vector const actual(ent.get_x(), ent.get_y());
+    //stopping is not eased, so a mob that just stopped is not about to reverse
+    Vector jerk(0, 0);
+    if (ent.acceleration.x != 0 || ent.acceleration.y != 0)
+        jerk = ent.acceleration - ent.last_acceleration;
+    ent.last_acceleration = ent.acceleration;
+    //new mobs, and mobs some client only just started extrapolating from their real position
+    uint8_t correct = ent.lifetime == 0 || ent.reckoning_resync;
+    ent.reckoning_resync = 0;
+    uint8_t steer = correct;
+    if (!correct) {
+        Vector vel(ent.get_motion_vx(), ent.get_motion_vy());
+        Vector accel(ent.get_motion_ax(), ent.get_motion_ay());
+        Vector const sent_jerk(ent.get_motion_jx(), ent.get_motion_jy());
+        reckon_step(ent, ent.reckoned_pos, vel, accel, sent_jerk);
+        ent.set_motion_vx(vel.x);
+        ent.set_motion_vy(vel.y);
+        ent.set_motion_ax(accel.x);
+        ent.set_motion_ay(accel.y);
+        correct = (actual - ent.reckoned_pos).magnitude() > RECKONING_TOLERANCE;
+        steer = correct || (ent.acceleration - accel).magnitude() > RECKONING_STEER_TOLERANCE
+            || (jerk - sent_jerk).magnitude() > RECKONING_STEER_TOLERANCE;
+    }
+    if (correct) {
+        ent.reckoned_pos = actual;
+        ent.set_motion_vx(ent.velocity.x);
+        ent.set_motion_vy(ent.velocity.y);
+    }
+    if (steer) {
+        ent.set_motion_ax(ent.acceleration.x);
+        ent.set_motion_ay(ent.acceleration.y);
+        ent.set_motion_jx(jerk.x);
+        ent.set_motion_jy(jerk.y);
+    }
+    ent.set_state_x(correct);
+    ent.set_state_y(correct);
+    ent.set_state_motion_vx(correct);
+    ent.set_state_motion_vy(correct);
+    ent.set_state_motion_ax(steer);
+    ent.set_state_motion_ay(steer);
+    ent.set_state_motion_jx(steer);
+    ent.set_state_motion_jy(steer);
+}
+#endif
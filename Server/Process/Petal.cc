@@ -3,6 +3,7 @@
 #include <Server/EntityFunctions.hh>
 #include <Server/Spawn.hh>
 #include <Shared/Entity.hh>
+#include <Shared/Orbit.hh>
 #include <Shared/Simulation.hh>
 #include <Shared/StaticData.hh>
 
@@ -222,4 +223,32 @@ void tick_petal_behavior(Simulation *sim, Entity &petal) {
         default:
             break;
     }
-}
\ No newline at end of file
+}
+
+#ifdef ORBIT_PREDICTION
+//after motion: orbiting petals that landed near the prediction stay out of the update,
+//the rest send their position and velocity and the prediction starts over from there
+void tick_petal_orbit(Simulation *sim, Entity &petal) {
+    uint8_t flags = petal.get_petal_flags();
+    if (petal.orbit_driven) BitMath::set(flags, PetalFlags::kOrbiting);
+    else BitMath::unset(flags, PetalFlags::kOrbiting);
+    petal.set_petal_flags(flags);
+    if (petal.orbit_driven) {
+        Vector actual(petal.get_x(), petal.get_y());
+        uint8_t correct = !petal.orbit_stepped || (actual - petal.orbit_pos).magnitude() > ORBIT_TOLERANCE;
+        if (correct) {
+            petal.orbit_pos = actual;
+            petal.set_orbit_vx(petal.velocity.x);
+            petal.set_orbit_vy(petal.velocity.y);
+        }
+        //clients turn the petal themselves, so corrections only send the angle if it changed
+        if (!correct) petal.set_state_angle(0);
+        petal.set_state_x(correct);
+        petal.set_state_y(correct);
+        petal.set_state_orbit_vx(correct);
+        petal.set_state_orbit_vy(correct);
+    }
+    petal.orbit_driven = 0;
+    petal.orbit_stepped = 0;
+}
+#endif
@@ -0,0 +1,169 @@
+#include <Server/Profiler.hh>
+
+#ifdef PROFILER
+#include <algorithm>
+#include <bit>
+#include <iostream>
+
+using namespace Profiler;
+
+char const *Profiler::STAGE_NAMES[kStageCount] = {
+    "simulation",
+    "team_manager",
+    "update_clients",
+    "post_tick",
+    "game_tick",
+    "flush",
+    "server_tick"
+};
+
+//filled in by the scheduler during static initialization, so keep these constant-initialized
+static char const *system_names[MAX_SYSTEMS] = {};
+static uint32_t system_count = 0;
+
+static Histogram stage_histograms[kStageCount];
+static Histogram system_histograms[MAX_SYSTEMS];
+static thread_local TickRecord *current = nullptr;
+
+uint32_t Histogram::bucket_of(uint64_t v) {
+    v = std::min<uint64_t>(v, (1ull << MAX_BITS) - 1);
+    if (v < (1ull << SUB_BITS)) return v;
+    uint32_t const shift = std::bit_width(v) - SUB_BITS - 1;
+    return ((shift + 1) << SUB_BITS) + (v >> shift) - (1 << SUB_BITS);
+}
+
+//midpoint of the bucket
+uint64_t Histogram::bucket_value(uint32_t bucket) {
+    if (bucket < (1u << SUB_BITS)) return bucket;
+    uint32_t const shift = (bucket >> SUB_BITS) - 1;
+    uint64_t const low = static_cast<uint64_t>((bucket & ((1 << SUB_BITS) - 1)) + (1 << SUB_BITS)) << shift;
+    return low + (1ull << shift) / 2;
+}
+
+void Histogram::record(uint64_t ns) {
+    counts[bucket_of(ns)].fetch_add(1, std::memory_order_relaxed);
+    total.fetch_add(ns, std::memory_order_relaxed);
+    uint64_t prev = max.load(std::memory_order_relaxed);
+    while (prev < ns && !max.compare_exchange_weak(prev, ns, std::memory_order_relaxed));
+}
+
+uint64_t Histogram::count() const {
+    uint64_t n = 0;
+    for (std::atomic<uint32_t> const &c : counts) n += c.load(std::memory_order_relaxed);
+    return n;
+}
+
+uint64_t Histogram::percentile(double p) const {
+    uint64_t const n = count();
+    if (n == 0) return 0;
+    uint64_t const target = std::max<uint64_t>(1, n * p + 0.5);
+    uint64_t seen = 0;
+    for (uint32_t i = 0; i < BUCKETS; ++i) {
+        seen += counts[i].load(std::memory_order_relaxed);
+        if (seen >= target) return std::min(bucket_value(i), max.load(std::memory_order_relaxed));
+    }
+    return max.load(std::memory_order_relaxed);
+}
+
+void Histogram::print(char const *name, uint64_t n) const {
+    std::cout << "  " << name << ": mean " << total.load(std::memory_order_relaxed) / 1e6 / n
+        << "ms p50 " << percentile(0.5) / 1e6 << "ms p90 " << percentile(0.9) / 1e6
+        << "ms p99 " << percentile(0.99) / 1e6 << "ms max " << max.load(std::memory_order_relaxed) / 1e6 << "ms\n";
+}
+
+void Histogram::reset() {
+    for (std::atomic<uint32_t> &c : counts) c.store(0, std::memory_order_relaxed);
+    total.store(0, std::memory_order_relaxed);
+    max.store(0, std::memory_order_relaxed);
+}
+
+FlightRecorder::FlightRecorder() : records(), ticks(0), last_dump(0), last_dump_time(), suppressed(0) {}
+
+TickRecord &FlightRecorder::begin() {
+    TickRecord &record = records[ticks % FLIGHT_RECORDER_SIZE];
+    record = {};
+    record.tick = ticks;
+    current = &record;
+    return record;
+}
+
+void FlightRecorder::end() {
+    current = nullptr;
+    ++ticks;
+}
+
+//only called between ticks, while the game thread is parked
+void FlightRecorder::dump(char const *name) {
+    using namespace std::chrono;
+    if (ticks == last_dump) return;
+    //a run of slow ticks gives one dump per cooldown, the skipped ones are counted like log lines
+    steady_clock::time_point const now = steady_clock::now();
+    if (last_dump != 0 && now - last_dump_time < seconds(FLIGHT_RECORDER_COOLDOWN)) {
+        ++suppressed;
+        return;
+    }
+    if (suppressed > 0)
+        std::cout << "suppressed " << suppressed << " flight recorder dumps (" << name << ")\n";
+    suppressed = 0;
+    //every tick is printed at most once
+    uint64_t const first = std::max(last_dump, ticks > FLIGHT_RECORDER_SIZE ? ticks - FLIGHT_RECORDER_SIZE : 0);
+    last_dump = ticks;
+    last_dump_time = now;
+    std::cout << "Flight Recorder (" << name << ", ticks " << first << "-" << ticks - 1 << "): {\n";
+    for (uint64_t tick = first; tick < ticks; ++tick) {
+        TickRecord const &record = records[tick % FLIGHT_RECORDER_SIZE];
+        std::cout << "  " << record.tick << ": entities " << record.entity_count
+            << " clients " << record.client_count << " packets " << record.packet_count
+            << " bytes " << record.packet_bytes;
+        for (uint32_t i = 0; i < kStageCount; ++i)
+            if (record.stage_ns[i] > 0) std::cout << ' ' << STAGE_NAMES[i] << ' ' << record.stage_ns[i] / 1e3 << "us";
+        std::cout << " |";
+        for (uint32_t i = 0; i < system_count; ++i)
+            std::cout << ' ' << system_names[i] << ' ' << record.system_ns[i] / 1e3 << "us";
+        std::cout << '\n';
+    }
+    std::cout << "}\n";
+}
+
+ScopedTimer::ScopedTimer(Stage s) : stage(s), start(std::chrono::steady_clock::now()) {}
+
+ScopedTimer::~ScopedTimer() {
+    using namespace std::chrono;
+    record_stage(stage, duration_cast<nanoseconds>(steady_clock::now() - start).count());
+}
+
+TickRecord *Profiler::current_record() {
+    return current;
+}
+
+void Profiler::record_stage(Stage stage, uint64_t ns) {
+    stage_histograms[stage].record(ns);
+    if (current != nullptr) current->stage_ns[stage] = std::min<uint64_t>(ns, UINT32_MAX);
+}
+
+void Profiler::name_system(uint32_t index, char const *name) {
+    assert(index < MAX_SYSTEMS);
+    system_names[index] = name;
+    system_count = std::max(system_count, index + 1);
+}
+
+void Profiler::record_system(uint32_t index, uint64_t ns) {
+    system_histograms[index].record(ns);
+    if (current != nullptr) current->system_ns[index] = std::min<uint64_t>(ns, UINT32_MAX);
+}
+
+void Profiler::print_histograms() {
+    std::cout << "Tick Histograms: {\n";
+    for (uint32_t i = 0; i < kStageCount; ++i) {
+        uint64_t const n = stage_histograms[i].count();
+        if (n > 0) stage_histograms[i].print(STAGE_NAMES[i], n);
+        stage_histograms[i].reset();
+    }
+    for (uint32_t i = 0; i < system_count; ++i) {
+        uint64_t const n = system_histograms[i].count();
+        if (n > 0) system_histograms[i].print(system_names[i], n);
+        system_histograms[i].reset();
+    }
+    std::cout << "}\n";
+}
+#endif
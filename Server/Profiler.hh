@@ -0,0 +1,100 @@
+#pragma once
+
+#include <Helpers/Macros.hh>
+
+//built only with -DPROFILER=1, every hook below compiles to nothing otherwise
+#ifdef PROFILER
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+class Simulation;
+
+namespace Profiler {
+    enum Stage : uint8_t {
+        //per game, measured on the game's thread
+        kSimulation,
+        kTeamManager,
+        kUpdateClients,
+        kPostTick,
+        kGameTick,
+        //whole server, measured on the socket thread
+        kFlush,
+        kServerTick,
+        kStageCount
+    };
+
+    extern char const *STAGE_NAMES[kStageCount];
+
+    uint32_t const MAX_SYSTEMS = 32;
+    //ticks kept by each game's flight recorder
+    uint32_t const FLIGHT_RECORDER_SIZE = 256;
+    //seconds between dumps of one game's flight recorder
+    uint32_t const FLIGHT_RECORDER_COOLDOWN = 10;
+
+    //log-linear buckets: exact below 32ns, then 32 buckets per power of two (~3% error)
+    class Histogram {
+        static uint32_t const SUB_BITS = 5;
+        static uint32_t const MAX_BITS = 40;
+        static uint32_t const BUCKETS = (MAX_BITS - SUB_BITS + 1) << SUB_BITS;
+        std::array<std::atomic<uint32_t>, BUCKETS> counts;
+        std::atomic<uint64_t> total;
+        std::atomic<uint64_t> max;
+        static uint32_t bucket_of(uint64_t);
+        static uint64_t bucket_value(uint32_t);
+    public:
+        void record(uint64_t);
+        uint64_t count() const;
+        uint64_t percentile(double) const;
+        void print(char const *, uint64_t) const;
+        void reset();
+    };
+
+    struct TickRecord {
+        uint64_t tick;
+        uint32_t entity_count;
+        uint32_t client_count;
+        uint32_t packet_count;
+        uint32_t packet_bytes;
+        std::array<uint32_t, kStageCount> stage_ns;
+        //summed over chunks, so may exceed the stage time when run on workers
+        std::array<uint32_t, MAX_SYSTEMS> system_ns;
+    };
+
+    //ring of the last FLIGHT_RECORDER_SIZE ticks of one game
+    class FlightRecorder {
+        std::array<TickRecord, FLIGHT_RECORDER_SIZE> records;
+        uint64_t ticks;
+        uint64_t last_dump;
+        std::chrono::steady_clock::time_point last_dump_time;
+        //dumps skipped since the last one, reported with the next
+        uint32_t suppressed;
+    public:
+        FlightRecorder();
+        TickRecord &begin();
+        void end();
+        void dump(char const *);
+    };
+
+    class ScopedTimer {
+        Stage stage;
+        std::chrono::steady_clock::time_point start;
+    public:
+        ScopedTimer(Stage);
+        ~ScopedTimer();
+    };
+
+    //record being filled by the calling thread, nullptr outside a game tick
+    TickRecord *current_record();
+    void record_stage(Stage, uint64_t);
+    void name_system(uint32_t, char const *);
+    void record_system(uint32_t, uint64_t);
+    //prints percentiles since the last call, then starts over
+    void print_histograms();
+}
+
+#define PROFILE_SCOPE(stage) Profiler::ScopedTimer _profile_scope_##stage(Profiler::stage)
+#else
+#define PROFILE_SCOPE(stage)
+#endif
@@ -0,0 +1,165 @@
+#include <Server/Handover.hh>
+#include <Server/Headless.hh>
+#include <Server/Journal.hh>
+#include <Server/Log.hh>
+#include <Server/Profiler.hh>
+#include <Server/Scheduler.hh>
+#include <Server/Server.hh>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+//re-runs a journal written with GARDN_JOURNAL as fast as possible
+//usage: gardn-replay <journal> [--timings]
+
+class JournalReader {
+    std::vector<uint8_t> data;
+    size_t at = 0;
+public:
+    //set once a read runs past the end, reads after that return nothing
+    bool failed = false;
+    JournalReader(std::vector<uint8_t> &&bytes) : data(std::move(bytes)) {}
+    bool has(size_t size) const { return at + size <= data.size(); }
+    template<typename T>
+    T read() {
+        T v{};
+        if (failed || !has(sizeof(T))) {
+            failed = true;
+            return v;
+        }
+        std::memcpy(&v, data.data() + at, sizeof(T));
+        at += sizeof(T);
+        return v;
+    }
+    std::string_view read_bytes(uint32_t size) {
+        if (failed || !has(size)) {
+            failed = true;
+            return {};
+        }
+        std::string_view bytes(reinterpret_cast<char const *>(data.data() + at), size);
+        at += size;
+        return bytes;
+    }
+};
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        std::cout << "usage: " << argv[0] << " <journal> [--timings]\n";
+        return 1;
+    }
+    bool const print_timings = argc > 2 && std::string(argv[2]) == "--timings";
+    std::ifstream file(argv[1], std::ios::binary);
+    if (!file) {
+        std::cout << "could not open " << argv[1] << '\n';
+        return 1;
+    }
+    JournalReader reader(std::vector<uint8_t>(std::istreambuf_iterator<char>(file), {}));
+    if (!reader.has(sizeof(uint64_t) * 2 + sizeof(uint32_t) * 2)
+        || reader.read<uint64_t>() != Journal::MAGIC
+        || reader.read<uint32_t>() != Journal::VERSION) {
+        std::cout << "not a journal\n";
+        return 1;
+    }
+    if (reader.read<uint64_t>() != VERSION_HASH)
+        std::cout << "warning: journal was recorded with a different VERSION_HASH, clients will be rejected\n";
+    uint32_t const game_count = reader.read<uint32_t>();
+    if (game_count != Server::games.size() || !reader.has(sizeof(uint64_t) * game_count)) {
+        std::cout << "journal has " << game_count << " games, expected " << Server::games.size() << '\n';
+        return 1;
+    }
+    for (GameInstance &game : Server::games) {
+        game.init(reader.read<uint64_t>());
+        game.start_worker();
+    }
+
+    std::unordered_map<uint32_t, WebSocket *> sockets;
+    std::vector<double> tick_times;
+    while (reader.has(sizeof(uint8_t))) {
+        switch (reader.read<uint8_t>()) {
+            case Journal::kTick: {
+                auto start = std::chrono::steady_clock::now();
+                Server::tick();
+                std::chrono::duration<double, std::milli> tick_time = std::chrono::steady_clock::now() - start;
+                tick_times.push_back(tick_time.count());
+                break;
+            }
+            case Journal::kConnect: {
+                uint32_t id = reader.read<uint32_t>();
+                if (reader.failed) break;
+                sockets[id] = Headless::connect();
+                break;
+            }
+            case Journal::kMessage: {
+                uint32_t id = reader.read<uint32_t>();
+                uint32_t size = reader.read<uint32_t>();
+                std::string_view message = reader.read_bytes(size);
+                if (reader.failed) break;
+                auto iter = sockets.find(id);
+                if (iter != sockets.end()) Headless::message(iter->second, message);
+                break;
+            }
+            case Journal::kDisconnect: {
+                uint32_t id = reader.read<uint32_t>();
+                int32_t code = reader.read<int32_t>();
+                if (reader.failed) break;
+                auto iter = sockets.find(id);
+                if (iter == sockets.end()) break;
+                Headless::disconnect(iter->second, code);
+                sockets.erase(iter);
+                break;
+            }
+            case Journal::kDrain:
+                Server::is_draining = true;
+                break;
+            case Journal::kHandover: {
+                uint32_t size = reader.read<uint32_t>();
+                std::string_view bytes = reader.read_bytes(size);
+                if (reader.failed) break;
+                Handover::restore(std::vector<uint8_t>(bytes.begin(), bytes.end()));
+                break;
+            }
+            case Journal::kRecoveryId: {
+                uint64_t id = reader.read<uint64_t>();
+                if (reader.failed) break;
+                Journal::replay_recovery_id(id);
+                break;
+            }
+            default:
+                std::cout << "corrupt journal\n";
+                return 1;
+        }
+        if (reader.failed) {
+            std::cout << "truncated journal\n";
+            return 1;
+        }
+    }
+
+    Log::flush();
+    if (tick_times.empty()) return 0;
+    double total = 0;
+    for (double t : tick_times) total += t;
+    std::sort(tick_times.begin(), tick_times.end());
+    auto percentile = [&](double p) { return tick_times[(tick_times.size() - 1) * p]; };
+    std::cout << "Replay: {\n";
+    std::cout << "  Ticks: " << tick_times.size() << '\n';
+    std::cout << "  Total: " << total << "ms\n";
+    std::cout << "  Mean: " << total / tick_times.size() << "ms\n";
+    std::cout << "  p50: " << percentile(0.5) << "ms\n";
+    std::cout << "  p99: " << percentile(0.99) << "ms\n";
+    std::cout << "  Max: " << tick_times.back() << "ms\n";
+    std::cout << "  Bytes Sent: " << Headless::get_bytes_sent() << '\n';
+    std::cout << "}\n";
+    if (print_timings) {
+        for (GameInstance &game : Server::games)
+            TICK_SCHEDULER.print_timings(game.simulation.system_timings, game.get_name());
+        PROFILE_ONLY(Profiler::print_histograms();)
+    }
+    return 0;
+}
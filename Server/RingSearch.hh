@@ -0,0 +1,98 @@
+#pragma once
+
+#include <Shared/Entity.hh>
+
+#include <Helpers/Math.hh>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+class Simulation;
+
+typedef std::function<bool(Simulation *, Entity &)> SearchPredicate;
+
+//visits grid cells in square rings around (x, y), the point's own cell first
+//after each ring, stops once every cell left is at least cutoff() away (less slack)
+//slack is how much closer an entity can be than the cell it is filed under
+template<typename Visit, typename Cutoff>
+void ring_search(float x, float y, float cell_size, uint32_t width, uint32_t height, float slack, Visit visit, Cutoff cutoff) {
+    int32_t const cx = fclamp(x, 0, width * cell_size - 1) / cell_size;
+    int32_t const cy = fclamp(y, 0, height * cell_size - 1) / cell_size;
+    for (int32_t r = 0;; ++r) {
+        for (int32_t _x = std::max(cx - r, 0); _x <= std::min<int32_t>(cx + r, width - 1); ++_x) {
+            if (cy - r >= 0) visit(_x, cy - r);
+            if (r > 0 && cy + r < (int32_t) height) visit(_x, cy + r);
+        }
+        for (int32_t _y = std::max(cy - r + 1, 0); _y <= std::min<int32_t>(cy + r - 1, height - 1); ++_y) {
+            if (r > 0 && cx - r >= 0) visit(cx - r, _y);
+            if (r > 0 && cx + r < (int32_t) width) visit(cx + r, _y);
+        }
+        //distance to the nearest side of the visited square that still has cells past it
+        float next = INFINITY;
+        if (cx - r > 0) next = std::min(next, x - (cx - r) * cell_size);
+        if (cx + r + 1 < (int32_t) width) next = std::min(next, (cx + r + 1) * cell_size - x);
+        if (cy - r > 0) next = std::min(next, y - (cy - r) * cell_size);
+        if (cy + r + 1 < (int32_t) height) next = std::min(next, (cy + r + 1) * cell_size - y);
+        if (next == INFINITY || next - slack >= cutoff()) return;
+    }
+}
+
+//distance from a point to an entity's center, or to its edge
+inline float search_distance(float x, float y, Entity const &ent, bool to_edge) {
+    float dist = Vector(ent.get_x() - x, ent.get_y() - y).magnitude();
+    return to_edge ? dist - ent.get_radius() : dist;
+}
+
+//closest entity strictly within max_dist that passes the predicate
+struct NearestSearch {
+    float x;
+    float y;
+    bool to_edge;
+    float min_dist;
+    EntityID best;
+    NearestSearch(float _x, float _y, float max_dist, bool _to_edge)
+        : x(_x), y(_y), to_edge(_to_edge), min_dist(max_dist) {}
+    float cutoff() const { return min_dist; }
+    void consider(Simulation *sim, Entity &ent, SearchPredicate const &predicate) {
+        float dist = search_distance(x, y, ent, to_edge);
+        if (dist >= min_dist) return;
+        if (!predicate(sim, ent)) return;
+        min_dist = dist;
+        best = ent.id;
+    }
+};
+
+//up to k closest entities strictly within max_dist that pass the predicate, nearest first
+struct KNearestSearch {
+    float x;
+    float y;
+    bool to_edge;
+    float max_dist;
+    uint32_t k;
+    std::vector<std::pair<float, EntityID>> found;
+    KNearestSearch(float _x, float _y, float _max_dist, bool _to_edge, uint32_t _k)
+        : x(_x), y(_y), to_edge(_to_edge), max_dist(_max_dist), k(_k) {}
+    float cutoff() const { return found.size() < k ? max_dist : found.back().first; }
+    void consider(Simulation *sim, Entity &ent, SearchPredicate const &predicate) {
+        if (k == 0) return;
+        float dist = search_distance(x, y, ent, to_edge);
+        if (dist >= cutoff()) return;
+        //grids that file an entity under every cell it touches hand it over more than once
+        for (auto const &entry : found) if (entry.second == ent.id) return;
+        if (!predicate(sim, ent)) return;
+        auto at = std::upper_bound(found.begin(), found.end(), dist,
+            [](float d, std::pair<float, EntityID> const &entry) { return d < entry.first; });
+        found.insert(at, {dist, ent.id});
+        if (found.size() > k) found.pop_back();
+    }
+    std::vector<EntityID> result() const {
+        std::vector<EntityID> ret;
+        ret.reserve(found.size());
+        for (auto const &entry : found) ret.push_back(entry.second);
+        return ret;
+    }
+};
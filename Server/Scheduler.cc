@@ -0,0 +1,246 @@
+#include <Server/Scheduler.hh>
+
+#include <Server/Trace.hh>
+
+#include <Shared/Simulation.hh>
+
+#include <array>
+#include <cassert>
+#include <chrono>
+#include <functional>
+#include <iostream>
+
+#ifndef WASM_SERVER
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#endif
+
+//entities per chunk below which splitting a system is not worth it
+static uint32_t const MIN_CHUNK_SIZE = 256;
+
+typedef std::function<void()> Task;
+
+#ifdef WASM_SERVER
+class WorkerPool {
+public:
+    uint32_t size() const { return 0; }
+    void run(std::vector<Task> &tasks) {
+        for (Task &task : tasks) task();
+    }
+};
+#else
+//each worker owns a deque and pops from its back,
+//idle workers and the submitting thread steal from the front of the others
+class WorkerPool {
+    struct Batch {
+        std::atomic<uint32_t> remaining;
+    };
+    struct Job {
+        Task *task;
+        Batch *batch;
+    };
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+    uint32_t const count;
+    std::vector<std::thread> threads;
+    std::unique_ptr<Queue[]> queues;
+    std::mutex sleep_mutex;
+    std::condition_variable wake;
+    std::atomic<uint32_t> queued;
+    std::atomic<uint32_t> next_queue;
+    bool stopping;
+
+    bool try_run(uint32_t home) {
+        for (uint32_t i = 0; i < count; ++i) {
+            uint32_t const index = (home + i) % count;
+            Queue &queue = queues[index];
+            Job job;
+            {
+                std::lock_guard<std::mutex> lock(queue.mutex);
+                if (queue.jobs.empty()) continue;
+                if (i == 0) {
+                    job = queue.jobs.back();
+                    queue.jobs.pop_back();
+                } else {
+                    job = queue.jobs.front();
+                    queue.jobs.pop_front();
+                }
+            }
+            queued.fetch_sub(1, std::memory_order_relaxed);
+            (*job.task)();
+            job.batch->remaining.fetch_sub(1, std::memory_order_release);
+            return true;
+        }
+        return false;
+    }
+public:
+    WorkerPool(uint32_t workers) : count(workers), queues(new Queue[workers]), queued(0), next_queue(0), stopping(false) {
+        threads.reserve(count);
+        for (uint32_t i = 0; i < count; ++i) {
+            threads.emplace_back([this, i](){
+                Trace::name_thread("scheduler worker");
+                while (1) {
+                    if (try_run(i)) continue;
+                    std::unique_lock<std::mutex> lock(sleep_mutex);
+                    wake.wait(lock, [this](){ return stopping || queued.load(std::memory_order_relaxed) > 0; });
+                    if (stopping) return;
+                }
+            });
+        }
+    }
+
+    ~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (std::thread &thread : threads) thread.join();
+    }
+
+    uint32_t size() const { return count; }
+
+    //blocks until every task has run, helping out in the meantime
+    void run(std::vector<Task> &tasks) {
+        if (count == 0 || tasks.size() <= 1) {
+            for (Task &task : tasks) task();
+            return;
+        }
+        Batch batch;
+        batch.remaining.store(tasks.size(), std::memory_order_relaxed);
+        uint32_t const start = next_queue.fetch_add(1, std::memory_order_relaxed);
+        for (uint32_t i = 0; i < tasks.size(); ++i) {
+            Queue &queue = queues[(start + i) % count];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.jobs.push_back({&tasks[i], &batch});
+        }
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex);
+            queued.fetch_add(tasks.size(), std::memory_order_relaxed);
+        }
+        wake.notify_all();
+        while (batch.remaining.load(std::memory_order_acquire) > 0)
+            if (!try_run(start)) std::this_thread::yield();
+    }
+};
+#endif
+
+static WorkerPool &get_pool() {
+    #if defined(WASM_SERVER)
+    static WorkerPool pool;
+    #elif defined(SCHEDULER_THREADS)
+    static WorkerPool pool(SCHEDULER_THREADS);
+    #else
+    //every game already ticks on its own thread
+    uint32_t const cores = std::thread::hardware_concurrency();
+    static WorkerPool pool(cores > Gamemode::kNumGamemodes ? cores - Gamemode::kNumGamemodes : 0);
+    #endif
+    return pool;
+}
+
+static bool conflicts(System const &a, System const &b) {
+    return (a.writes & (b.reads | b.writes)) || (b.writes & a.reads);
+}
+
+SystemScheduler::SystemScheduler(std::initializer_list<System> list) : systems(list),
+    dependencies(systems.size()), stage_of(systems.size(), 0) {
+    assert(systems.size() <= SystemTimings::MAX_SYSTEMS);
+    for (uint32_t i = 0; i < systems.size(); ++i) {
+        PROFILE_ONLY(Profiler::name_system(i, systems[i].name);)
+        //entity loops walk the entity tracker
+        if (systems[i].per_entity != nullptr)
+            systems[i].reads |= SystemAccess::kLifetime;
+        if (systems[i].awake_only)
+            systems[i].reads |= SystemAccess::kFlags;
+        for (uint32_t j = 0; j < i; ++j) {
+            if (!conflicts(systems[i], systems[j])) continue;
+            dependencies[i].push_back(j);
+            stage_of[i] = std::max(stage_of[i], stage_of[j] + 1);
+        }
+        if (stage_of[i] >= stages.size()) stages.resize(stage_of[i] + 1);
+        stages[stage_of[i]].push_back(i);
+    }
+}
+
+//tick_ns collects this tick's per system time for the profiler, nullptr when it is compiled out
+void SystemScheduler::run_stage(Simulation *sim, std::vector<uint32_t> const &stage, std::atomic<uint64_t> *tick_ns) {
+    using namespace std::chrono;
+    WorkerPool &pool = get_pool();
+    std::vector<Task> tasks;
+    for (uint32_t index : stage) {
+        System const &system = systems[index];
+        std::atomic<uint64_t> &elapsed = sim->system_timings.elapsed_ns[index];
+        std::atomic<uint64_t> *tick_elapsed = tick_ns == nullptr ? nullptr : &tick_ns[index];
+        uint32_t const count = system.per_entity == nullptr ? 0 : sim->active_entity_count();
+        uint32_t chunks = 1;
+        if (system.chunkable)
+            chunks = std::max(1u, std::min(pool.size() + 1, count / MIN_CHUNK_SIZE));
+        for (uint32_t chunk = 0; chunk < chunks; ++chunk) {
+            uint32_t const begin = count * chunk / chunks;
+            uint32_t const end = count * (chunk + 1) / chunks;
+            tasks.push_back([sim, &system, &elapsed, tick_elapsed, begin, end](){
+                TRACE_SPAN(system.name);
+                auto start = steady_clock::now();
+                //workers need the game's generator for frand()
+                RngScope rng_scope(sim->rng);
+                if (system.whole != nullptr) system.whole(sim);
+                else sim->for_each_in_range(system.component, begin, end, system.per_entity, system.awake_only);
+                uint64_t const ns = duration_cast<nanoseconds>(steady_clock::now() - start).count();
+                elapsed.fetch_add(ns, std::memory_order_relaxed);
+                if (tick_elapsed != nullptr) tick_elapsed->fetch_add(ns, std::memory_order_relaxed);
+            });
+        }
+    }
+    pool.run(tasks);
+}
+
+void SystemScheduler::run(Simulation *sim) {
+    #ifdef PROFILER
+    std::array<std::atomic<uint64_t>, Profiler::MAX_SYSTEMS> tick_ns = {};
+    for (std::vector<uint32_t> const &stage : stages)
+        run_stage(sim, stage, tick_ns.data());
+    for (uint32_t i = 0; i < systems.size(); ++i)
+        Profiler::record_system(i, tick_ns[i].load(std::memory_order_relaxed));
+    #else
+    for (std::vector<uint32_t> const &stage : stages)
+        run_stage(sim, stage, nullptr);
+    #endif
+    sim->system_timings.ticks.fetch_add(1, std::memory_order_relaxed);
+}
+
+void SystemScheduler::print_graph() const {
+    std::cout << "System Graph: {\n";
+    std::cout << "  Workers: " << get_pool().size() << '\n';
+    for (uint32_t i = 0; i < stages.size(); ++i) {
+        std::cout << "  Stage " << i << ":";
+        for (uint32_t index : stages[i]) {
+            std::cout << ' ' << systems[index].name;
+            if (systems[index].chunkable) std::cout << "[chunked]";
+            //only the dependencies that pin the system to this stage
+            char const *separator = " <- ";
+            for (uint32_t dep : dependencies[index]) {
+                if (stage_of[dep] + 1 != i) continue;
+                std::cout << separator << systems[dep].name;
+                separator = ", ";
+            }
+            if (index != stages[i].back()) std::cout << ';';
+        }
+        std::cout << '\n';
+    }
+    std::cout << "}\n";
+}
+
+void SystemScheduler::print_timings(SystemTimings &timings, char const *game) const {
+    uint32_t const count = timings.ticks.exchange(0, std::memory_order_relaxed);
+    if (count == 0) return;
+    std::cout << "System Timings (" << game << ", " << count << " ticks): {\n";
+    for (uint32_t i = 0; i < systems.size(); ++i) {
+        double const ms = timings.elapsed_ns[i].exchange(0, std::memory_order_relaxed) / 1e6 / count;
+        std::cout << "  " << systems[i].name << ": " << ms << "ms\n";
+    }
+    std::cout << "}\n";
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <Server/Profiler.hh>
+
+#include <Shared/Entity.hh>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <initializer_list>
+#include <vector>
+
+class Simulation;
+
+namespace SystemAccess {
+    //components occupy the low bits, shared resources the high bits
+    constexpr uint64_t component(uint32_t c) { return 1ull << c; }
+    uint64_t const kSpatialHash = 1ull << 32;
+    uint64_t const kRng = 1ull << 33;
+    //allocating, deleting or testing existence of entities
+    uint64_t const kLifetime = 1ull << 34;
+    uint64_t const kFlags = 1ull << 35;
+    //server-only per entity fields (PER_EXTRA_FIELD)
+    uint64_t const kExtra = 1ull << 36;
+    //arena info, petal tracker, team entities, leaderboard and other simulation-wide counters
+    uint64_t const kGlobal = 1ull << 37;
+    uint64_t const kAll = ~0ull;
+}
+
+struct System {
+    char const *name;
+    //entity loop, iterated like Simulation::for_each
+    //kComponentCount visits every entity like Simulation::for_each_entity
+    uint8_t component = kComponentCount;
+    void (*per_entity)(Simulation *, Entity &) = nullptr;
+    //used instead of per_entity for systems that are not entity loops
+    void (*whole)(Simulation *) = nullptr;
+    uint64_t reads = SystemAccess::kAll;
+    uint64_t writes = SystemAccess::kAll;
+    //per_entity only writes the entity it is given,
+    //so the entity list can be split between threads
+    bool chunkable = false;
+    //per_entity skips entities with kIsDormant
+    bool awake_only = false;
+};
+
+//held by each simulation, games sharing the scheduler keep separate timings
+struct SystemTimings {
+    static uint32_t const MAX_SYSTEMS = 32;
+    std::array<std::atomic<uint64_t>, MAX_SYSTEMS> elapsed_ns = {};
+    std::atomic<uint32_t> ticks = 0;
+};
+
+class SystemScheduler {
+    std::vector<System> systems;
+    //systems in one stage never conflict with each other,
+    //and every conflicting pair keeps its registration order
+    std::vector<std::vector<uint32_t>> stages;
+    std::vector<std::vector<uint32_t>> dependencies;
+    std::vector<uint32_t> stage_of;
+    void run_stage(Simulation *, std::vector<uint32_t> const &, std::atomic<uint64_t> *);
+public:
+    SystemScheduler(std::initializer_list<System>);
+    void run(Simulation *);
+    void print_graph() const;
+    //prints and resets one game's timings since the last print
+    void print_timings(SystemTimings &, char const *) const;
+};
+
+extern SystemScheduler TICK_SCHEDULER;
@@ -1,41 +1,96 @@
 #include <Server/Server.hh>
 
+#include <Server/Bandwidth.hh>
 #include <Server/Game.hh>
 #include <Server/Client.hh>
+#include <Server/Handover.hh>
+#include <Server/Journal.hh>
+#include <Server/Log.hh>
+#include <Server/Metrics.hh>
+#include <Server/PetalTracker.hh>
+#include <Server/Profiler.hh>
+#include <Server/Scheduler.hh>
+#include <Server/Snapshot.hh>
+#include <Server/Trace.hh>
 
 #include <Shared/Binary.hh>
 
 #include <chrono>
-#include <iostream>
 
 static bool was_draining = false;
+static uint32_t ticks_since_report = 0;
 
 namespace Server {
-    uint8_t OUTGOING_PACKET[MAX_PACKET_LEN] = {0};
     std::array<GameInstance, Gamemode::kNumGamemodes> games = {
         GameInstance(Gamemode::kFFA),
         GameInstance(Gamemode::kTDM)
     };
-    std::array<uint32_t, PetalID::kNumPetals> petal_count_tracker = {0};
     volatile sig_atomic_t is_draining = false;
     bool is_stopping = false;
-    uint32_t player_count = 0;
 }
 
 using namespace Server;
 
+uint32_t Server::get_player_count() {
+    uint32_t count = 0;
+    for (GameInstance const &game : Server::games)
+        count += game.simulation.camera_count.load(std::memory_order_relaxed);
+    return count;
+}
+
 void Server::tick() {
     using namespace std::chrono_literals;
+    #ifndef WASM_SERVER
+    Trace::begin_tick();
+    #endif
     auto start = std::chrono::steady_clock::now();
-    for (GameInstance &game : Server::games) game.tick();
+    {
+        TRACE_SPAN("server_tick");
+        PROFILE_SCOPE(kServerTick);
+        Journal::record_tick();
+        #ifdef WASM_SERVER
+        for (GameInstance &game : Server::games) game.tick();
+        #else
+        for (GameInstance &game : Server::games) game.begin_tick();
+        for (GameInstance &game : Server::games) game.end_tick();
+        #endif
+        PetalTracker::end_tick();
+        TRACE_SPAN("flush");
+        PROFILE_SCOPE(kFlush);
+        for (GameInstance &game : Server::games) game.flush();
+    }
+    #ifndef WASM_SERVER
+    Trace::end_tick();
+    #endif
     auto end = std::chrono::steady_clock::now();
     std::chrono::duration<double, std::milli> tick_time = end - start;
-    if (tick_time > 1000ms / TPS) std::cout << "tick took " << tick_time << '\n';
+    #ifndef WASM_SERVER
+    Metrics::record_tick(tick_time.count());
+    Snapshot::tick();
+    #endif
+    if (tick_time > 1000ms / TPS) {
+        Log::write(Log::kSlowTick, { .value = tick_time.count() });
+        PROFILE_ONLY(for (GameInstance &game : Server::games) game.dump_flight_recorder();)
+    }
+    if (++ticks_since_report == 60 * TPS) {
+        ticks_since_report = 0;
+        for (GameInstance &game : Server::games)
+            TICK_SCHEDULER.print_timings(game.simulation.system_timings, game.get_name());
+        PROFILE_ONLY(Profiler::print_histograms();)
+        PROFILE_ONLY(Bandwidth::print_report(60 * TPS);)
+    }
 
+    Handover::poll();
     if (Server::is_draining && !was_draining) {
         was_draining = true;
-        std::cout << "draining...\n";
+        Log::info("draining...");
+        //once the sessions are written the next process owns them, send everyone over right away
+        if (Handover::save()) {
+            for (GameInstance &game : Server::games)
+                game.disconnect_all(CloseReason::kOutdated, "Outdated Version");
+            Server::stop();
+        }
     }
-    if (Server::is_draining && !Server::is_stopping && Server::player_count == 0)
+    if (Server::is_draining && !Server::is_stopping && Server::get_player_count() == 0)
         Server::stop();
 }
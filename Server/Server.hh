@@ -9,7 +9,7 @@ class Client;
 
 size_t const MAX_PACKET_LEN = 64 * 1024;
 
-#ifdef WASM_SERVER
+#if defined(WASM_SERVER) || defined(HEADLESS_SERVER)
 class WebSocketServer {
 public:
     WebSocketServer();
@@ -20,15 +20,13 @@ typedef uWS::App WebSocketServer;
 #endif
 
 namespace Server {
-    extern uint8_t OUTGOING_PACKET[MAX_PACKET_LEN];
     extern std::array<GameInstance, Gamemode::kNumGamemodes> games;
-    extern std::array<uint32_t, PetalID::kNumPetals> petal_count_tracker;
     #ifdef WASM_SERVER
     extern WebSocketServer server;
     #endif
     extern volatile sig_atomic_t is_draining;
     extern bool is_stopping;
-    extern uint32_t player_count;
+    extern uint32_t get_player_count();
     extern void init();
     extern void run();
     extern void tick();
@@ -3,81 +3,147 @@
 #include <Server/Process.hh>
 #include <Server/Client.hh>
 #include <Server/EntityFunctions.hh>
+#include <Server/Scheduler.hh>
 #include <Server/Server.hh>
 #include <Server/Spawn.hh>
 #include <Server/SpatialHash.hh>
 
 #include <Shared/Map.hh>
 
-#include <algorithm>
-#include <vector>
+#include <limits>
 
 static void calculate_leaderboard(Simulation *sim) {
-    std::vector<Entity *> players;
-    sim->for_each<kCamera>([&](Simulation *sim, Entity &ent) { 
-        if (sim->ent_alive(ent.get_player())) {
-            Entity &player = sim->get_ent(ent.get_player());
-            player.set_leaderboard_pos(LEADERBOARD_SIZE);
-            players.push_back(&player);
-        }
-    });
-    std::stable_sort(players.begin(), players.end(), [](Entity const *a, Entity const *b){
-        return a->get_score() > b->get_score();
-    });
-    uint32_t num = players.size();
-    sim->arena_info.set_player_count(num);
-    num = std::min(num, LEADERBOARD_SIZE);
-    for (uint32_t i = 0; i < num; ++i) {
-        players[i]->set_leaderboard_pos(i);
-        sim->arena_info.set_names(i, players[i]->get_name());
-        sim->arena_info.set_scores(i, players[i]->get_score());
-        if (sim->arena_info.gamemode == Gamemode::kTDM)
-            sim->arena_info.set_colors(i, players[i]->get_color());
-        else
-            sim->arena_info.set_colors(i, ColorID::kGreen);
-    }
+    sim->leaderboard.update(sim);
 }
 
-void Simulation::on_tick() {
-    spatial_hash.refresh(ARENA_WIDTH, ARENA_HEIGHT);
+static void _spawn_random_mobs(Simulation *sim) {
+    sim->spatial_hash.refresh(ARENA_WIDTH, ARENA_HEIGHT);
+    sim->threat_grid.clear();
     if (frand() < 1.0f / TPS) {
         for (uint32_t i = 0; i < 10; ++i) {
             Vector v;
-            if (Map::find_spawn_location(this, 500, v))
-                Map::spawn_random_mob(this, v.x, v.y);
+            if (Map::find_spawn_location(sim, 500, v))
+                Map::spawn_random_mob(sim, v.x, v.y);
         }
     }
-    for_each_entity([](Simulation *sim, Entity &ent) {
-        DEBUG_ONLY(assert(!(ent.has_component(kAnimation) && sim->ent_alive(ent.id)));)
-        if (ent.has_component(kPhysics) && !ent.has_component(kDot))
-            sim->spatial_hash.insert(ent);
-        if (BitMath::at(ent.flags, EntityFlags::kHasCulling))
-            BitMath::set(ent.flags, EntityFlags::kIsCulled);
-    });
-    for_each<kCamera>(tick_culling_behavior);
-    for_each<kFlower>(tick_player_behavior);
-    for_each<kMob>(tick_ai_behavior);
-    for_each<kCamera>(tick_player_ai_behavior);
-    for_each<kPetal>(tick_petal_behavior);
-    for_each<kHealth>(tick_health_behavior);
-    spatial_hash.collide(on_collide);
-    tick_curse_behavior(this);
-    for_each<kDrop>(tick_drop_behavior);
-    for_each<kPhysics>(tick_entity_motion);
-    for_each<kSegmented>(tick_segment_behavior);
-    for_each<kCamera>(tick_camera_behavior);
-    for_each<kScore>(tick_score_behavior);
-    for_each<kChat>(tick_chat_behavior);
-    for_each_entity(entity_clear_references);
-    calculate_leaderboard(this);
+}
+
+static void _insert_into_spatial_hash(Simulation *sim, Entity &ent) {
+    DEBUG_ONLY(assert(!(ent.has_component(kAnimation) && sim->ent_alive(ent.id)));)
+    //nothing can see or touch a dormant mob
+    if (BitMath::at(ent.flags, EntityFlags::kIsDormant)) return;
+    if (ent.has_component(kPhysics) && !ent.has_component(kDot)) {
+        sim->spatial_hash.insert(ent);
+        if (ent.has_component(kMob) || ent.has_component(kFlower))
+            sim->threat_grid.insert(ent);
+    }
+    if (BitMath::at(ent.flags, EntityFlags::kHasCulling)) {
+        BitMath::set(ent.flags, EntityFlags::kIsCulled);
+        ent.ai_camera_distance = std::numeric_limits<float>::max();
+    }
+}
+
+static void _collide(Simulation *sim) {
+    sim->spatial_hash.collide(on_collide);
+}
+
+using namespace SystemAccess;
+
+//allocating takes the entity tracker, a new entity is not in any other system's
+//entity list, so filling in its fields needs nothing beyond kLifetime
+static uint64_t const SPAWNS = kLifetime | kRng;
+//everything inflict_damage can touch: the defender's health and loadout summary,
+//the target it picks up, ant hole releases, lightning chains and yggdrasil deletes
+static uint64_t const DAMAGE_READS = component(kPhysics) | component(kRelations) | component(kPetal)
+    | component(kMob) | component(kFlower) | component(kHealth) | kFlags | kExtra | kLifetime | kSpatialHash;
+static uint64_t const DAMAGE_WRITES = component(kHealth) | component(kFlower) | kExtra | kSpatialHash | SPAWNS;
+
+//registration order is the serial order, systems whose declared accesses do not
+//conflict would share a stage, every conflicting pair keeps its order
+//with these accesses each system conflicts with the one before it (most move entities,
+//touch the extras or delete entities other loops walk), so the stages form one chain
+//and the parallelism inside a game comes from splitting chunkable systems between workers
+//spawn and collide reach nearly everything and keep the default all-access declaration
+SystemScheduler TICK_SCHEDULER({
+    { .name = "spawn", .whole = _spawn_random_mobs },
+    { .name = "dormancy", .whole = tick_dormancy,
+        .reads = component(kCamera) | component(kPhysics) | component(kMob) | kFlags, .writes = kFlags | kExtra },
+    { .name = "spatial_hash_insert", .per_entity = _insert_into_spatial_hash,
+        .reads = component(kPhysics) | component(kDot) | kFlags, .writes = kSpatialHash | kFlags | kExtra },
+    { .name = "culling", .component = kCamera, .per_entity = tick_culling_behavior,
+        .reads = component(kCamera) | component(kPhysics) | kSpatialHash, .writes = kFlags | kExtra },
+    //spawns petals and petal mobs, sets the camera's fov
+    { .name = "player", .component = kFlower, .per_entity = tick_player_behavior,
+        .reads = component(kFlower) | component(kPhysics) | component(kPetal) | component(kRelations)
+            | component(kMob) | component(kScore) | kExtra | kFlags | kLifetime,
+        .writes = component(kFlower) | component(kPhysics) | component(kPetal) | component(kCamera) | kExtra | SPAWNS },
+    { .name = "ai_think_budget", .whole = tick_ai_think_budget,
+        .reads = component(kMob) | component(kRelations) | kExtra | kFlags | kLifetime, .writes = kFlags },
+    { .name = "ai", .component = kMob, .per_entity = tick_ai_behavior,
+        .reads = component(kPhysics) | component(kRelations) | component(kMob) | component(kSegmented)
+            | component(kPetal) | component(kFlower) | kExtra | kFlags | kSpatialHash,
+        .writes = component(kPhysics) | component(kRelations) | kExtra | kFlags | SPAWNS, .awake_only = true },
+    { .name = "player_ai", .component = kCamera, .per_entity = tick_player_ai_behavior,
+        .reads = component(kCamera) | kFlags | kLifetime, .writes = 0 },
+    { .name = "petal", .component = kPetal, .per_entity = tick_petal_behavior,
+        .reads = DAMAGE_READS | component(kPetal),
+        .writes = DAMAGE_WRITES | component(kPhysics) | component(kPetal) | kFlags },
+    { .name = "health", .component = kHealth, .per_entity = tick_health_behavior,
+        .reads = DAMAGE_READS, .writes = DAMAGE_WRITES, .awake_only = true },
+    { .name = "collide", .whole = _collide },
+    //reads the leaderboard and the threat grid, keeps the leader's dot in arena_info
+    { .name = "curse", .whole = tick_curse_behavior,
+        .reads = DAMAGE_READS | kGlobal, .writes = DAMAGE_WRITES | component(kPhysics) | kGlobal },
+    //picking up or auto-deleting a drop goes through the petal tracker
+    { .name = "drop", .component = kDrop, .per_entity = tick_drop_behavior,
+        .reads = component(kDrop) | component(kPhysics) | component(kPetal) | component(kRelations)
+            | component(kFlower) | component(kScore) | kExtra | kFlags | kLifetime | kSpatialHash,
+        .writes = component(kDrop) | component(kPhysics) | component(kFlower) | component(kScore)
+            | kFlags | kLifetime | kGlobal },
+    { .name = "motion", .component = kPhysics, .per_entity = tick_entity_motion,
+        .reads = component(kPhysics) | component(kPetal) | component(kWeb) | component(kChat) | kExtra,
+        .writes = component(kPhysics) | kExtra, .chunkable = true, .awake_only = true },
+    #ifdef ORBIT_PREDICTION
+    { .name = "orbit", .component = kPetal, .per_entity = tick_petal_orbit,
+        .reads = component(kPhysics) | component(kPetal) | kExtra,
+        .writes = component(kPhysics) | component(kPetal) | kExtra, .chunkable = true },
+    #endif
+    { .name = "segment", .component = kSegmented, .per_entity = tick_segment_behavior,
+        .reads = component(kPhysics) | component(kSegmented) | kExtra, .writes = component(kPhysics) | kExtra, .awake_only = true },
+    #ifdef DEAD_RECKONING
+    { .name = "reckoning", .component = kMob, .per_entity = tick_mob_reckoning,
+        .reads = component(kPhysics) | component(kMob) | component(kSegmented) | kExtra,
+        .writes = component(kPhysics) | component(kMob) | kExtra, .chunkable = true, .awake_only = true },
+    #endif
+    //zombies decay through inflict_damage, cameras without a player are deleted
+    { .name = "camera", .component = kCamera, .per_entity = tick_camera_behavior,
+        .reads = DAMAGE_READS | component(kCamera) | component(kScore),
+        .writes = DAMAGE_WRITES | component(kCamera) | component(kPhysics) | kFlags | kLifetime },
+    { .name = "score", .component = kScore, .per_entity = tick_score_behavior,
+        .reads = component(kScore), .writes = kExtra, .chunkable = true },
+    { .name = "chat", .component = kChat, .per_entity = tick_chat_behavior,
+        .reads = component(kPhysics) | component(kRelations) | kExtra,
+        .writes = component(kPhysics) | kExtra | kLifetime, .chunkable = true },
+    { .name = "clear_references", .per_entity = entity_clear_references,
+        .reads = kLifetime, .writes = kAll & ~kLifetime, .chunkable = true },
+    { .name = "leaderboard", .whole = calculate_leaderboard,
+        .reads = component(kCamera) | component(kScore) | component(kName) | component(kRelations)
+            | component(kFlower) | kLifetime | kGlobal,
+        .writes = component(kFlower) | kGlobal }
+});
+
+void Simulation::on_tick() {
+    TICK_SCHEDULER.run(this);
 }
 
 void Simulation::post_tick() {
     arena_info.reset_protocol();
     for_each_entity([](Simulation *sim, Entity &ent) {
         //no deletions mid tick
-        ent.reset_protocol();
+        //dormant mobs are frozen, timers and lifetime included, and nothing touched their fields
+        if (BitMath::at(ent.flags, EntityFlags::kIsDormant)) return;
         ++ent.lifetime;
+        ent.reset_protocol();
         if (ent.has_component(kHealth)) {
             ent.set_damaged(0);
             ent.set_revived(0);
@@ -0,0 +1,191 @@
+#include <Server/Snapshot.hh>
+
+#include <Server/Game.hh>
+#include <Server/Log.hh>
+#include <Server/Server.hh>
+#include <Server/Trace.hh>
+
+#include <Shared/Entity.hh>
+#include <Shared/Simulation.hh>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+//changes whenever a component or field is added, removed or retyped
+static uint64_t const LAYOUT = fnv1a(
+    #define COMPONENT(name) #name ","
+    PERCOMPONENT
+    #undef COMPONENT
+    #define SINGLE(component, name, type) #component "." #name ":" #type ";"
+    #define MULTIPLE(component, name, type, amt) #component "." #name ":" #type "[" #amt "];"
+    PERFIELD
+    #undef SINGLE
+    #undef MULTIPLE
+    #define SINGLE(name, type, reset) #name ":" #type ";"
+    #define MULTIPLE(name, type, amt, reset) #name ":" #type "[" #amt "];"
+    PER_EXTRA_FIELD
+    #undef SINGLE
+    #undef MULTIPLE
+) ^ (static_cast<uint64_t>(sizeof(Entity)) << 32) ^ (ENTITY_CAP << 16)
+    ^ (PetalID::kNumPetals << 8) ^ MAP_DATA.size();
+
+static std::string snapshot_path;
+static uint32_t interval_ticks = 30 * TPS;
+static uint32_t ticks_until_snapshot = 0;
+
+//serializing every game takes milliseconds, so the socket thread only forks between ticks
+//and the child serializes its copy-on-write image of the games and writes it out
+//the writer thread waits for the child and logs the result, child is 0 when none is running
+static std::mutex &writer_mutex = *new std::mutex;
+static std::condition_variable &writer_ready = *new std::condition_variable;
+static pid_t child = 0;
+static std::chrono::steady_clock::time_point child_started;
+
+static double _ms_since(std::chrono::steady_clock::time_point start) {
+    std::chrono::duration<double, std::milli> time = std::chrono::steady_clock::now() - start;
+    return time.count();
+}
+
+//written next to the target and renamed, so a crash mid-write keeps the previous snapshot
+//runs in the forked child, which has no log thread, so failures only show in the return value
+static bool _write(std::vector<uint8_t> const &buffer) {
+    std::string const tmp_path = snapshot_path + ".tmp";
+    std::FILE *file = std::fopen(tmp_path.c_str(), "wb");
+    if (file == nullptr) return false;
+    bool written = std::fwrite(buffer.data(), 1, buffer.size(), file) == buffer.size();
+    written = std::fflush(file) == 0 && fsync(fileno(file)) == 0 && written;
+    written = std::fclose(file) == 0 && written;
+    if (!written || std::rename(tmp_path.c_str(), snapshot_path.c_str()) != 0) {
+        std::remove(tmp_path.c_str());
+        return false;
+    }
+    return true;
+}
+
+static void _start_writer() {
+    std::thread([](){
+        Trace::name_thread("snapshot writer");
+        while (1) {
+            std::unique_lock<std::mutex> lock(writer_mutex);
+            writer_ready.wait(lock, [](){ return child != 0; });
+            pid_t const pid = child;
+            lock.unlock();
+            int status = 0;
+            bool const written = waitpid(pid, &status, 0) == pid && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+            struct stat st;
+            if (written && stat(snapshot_path.c_str(), &st) == 0)
+                Log::info("wrote snapshot (" + std::to_string(st.st_size) + " bytes) in " + std::to_string(_ms_since(child_started)) + "ms");
+            else
+                Log::info("could not write snapshot " + snapshot_path);
+            lock.lock();
+            child = 0;
+        }
+    }).detach();
+}
+
+//returns how many games were restored, in order
+static uint32_t _load(uint8_t const *data, size_t size) {
+    Snapshot::Reader reader(data, size);
+    uint64_t magic = 0, layout = 0;
+    uint32_t version = 0, game_count = 0;
+    reader.read<uint64_t>(magic);
+    reader.read<uint32_t>(version);
+    reader.read<uint64_t>(layout);
+    reader.read<uint32_t>(game_count);
+    if (reader.failed || magic != Snapshot::MAGIC || version != Snapshot::VERSION) {
+        Log::info("ignoring snapshot with an unknown format");
+        return 0;
+    }
+    if (layout != LAYOUT || game_count != Server::games.size()) {
+        Log::info("ignoring snapshot from a build with a different entity layout");
+        return 0;
+    }
+    uint32_t restored = 0;
+    for (GameInstance &game : Server::games) {
+        auto start = std::chrono::steady_clock::now();
+        if (!game.load(reader)) {
+            Log::info(std::string("snapshot of ") + game.get_name() + " is corrupt");
+            break;
+        }
+        Log::info(std::string("restored ") + game.get_name() + " from snapshot ("
+            + std::to_string(game.simulation.active_entity_count()) + " entities) in "
+            + std::to_string(_ms_since(start)) + "ms");
+        ++restored;
+    }
+    return restored;
+}
+
+uint32_t Snapshot::init_games() {
+    uint32_t restored = 0;
+    if (char const *path = std::getenv("GARDN_SNAPSHOT")) {
+        snapshot_path = path;
+        if (char const *interval = std::getenv("GARDN_SNAPSHOT_INTERVAL"))
+            interval_ticks = std::max(1, std::atoi(interval)) * TPS;
+        ticks_until_snapshot = interval_ticks;
+        int fd = open(path, O_RDONLY);
+        struct stat st;
+        if (fd >= 0 && fstat(fd, &st) == 0 && st.st_size > 0) {
+            void *data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data != MAP_FAILED) {
+                restored = _load(static_cast<uint8_t const *>(data), st.st_size);
+                munmap(data, st.st_size);
+            }
+        }
+        if (fd >= 0) close(fd);
+        _start_writer();
+    }
+    for (uint32_t i = restored; i < Server::games.size(); ++i)
+        Server::games[i].init();
+    return restored;
+}
+
+void Snapshot::save(std::vector<uint8_t> &buffer) {
+    Writer writer(buffer);
+    writer.write<uint64_t>(MAGIC);
+    writer.write<uint32_t>(VERSION);
+    writer.write<uint64_t>(LAYOUT);
+    writer.write<uint32_t>(Server::games.size());
+    for (GameInstance const &game : Server::games)
+        game.save(writer);
+}
+
+void Snapshot::tick() {
+    if (snapshot_path.empty() || --ticks_until_snapshot > 0) return;
+    ticks_until_snapshot = interval_ticks;
+    {
+        std::lock_guard<std::mutex> lock(writer_mutex);
+        //the last snapshot is still going out, skip this one
+        if (child != 0) return;
+    }
+    TRACE_SPAN("snapshot");
+    auto start = std::chrono::steady_clock::now();
+    //every game is parked between ticks, so the child sees a consistent image
+    pid_t const pid = fork();
+    if (pid == 0) {
+        std::vector<uint8_t> buffer;
+        save(buffer);
+        _exit(_write(buffer) ? 0 : 1);
+    }
+    if (pid < 0) {
+        Log::info("could not fork for snapshot");
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(writer_mutex);
+        child = pid;
+        child_started = start;
+    }
+    writer_ready.notify_one();
+}
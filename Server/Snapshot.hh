@@ -0,0 +1,102 @@
+#pragma once
+
+#include <Helpers/Vector.hh>
+
+#include <Shared/EntityDef.hh>
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+//binary image of every game for warm starts after a crash or restart
+//entities go through the same PERFIELD and PER_EXTRA_FIELD lists as the protocol,
+//so a snapshot only loads into a build with the same entity layout, which the header checks
+//enabled by setting GARDN_SNAPSHOT to a path, rewritten every GARDN_SNAPSHOT_INTERVAL seconds
+namespace Snapshot {
+    uint64_t const MAGIC = 0x50414e534e445247ull; //GRDNSNAP
+    uint32_t const VERSION = 1;
+
+    class Writer {
+        std::vector<uint8_t> &buffer;
+    public:
+        Writer(std::vector<uint8_t> &b) : buffer(b) {}
+        void write_bytes(void const *bytes, size_t size) {
+            uint8_t const *at = static_cast<uint8_t const *>(bytes);
+            buffer.insert(buffer.end(), at, at + size);
+        }
+        template<typename T>
+        void write(T const &v) {
+            if constexpr (std::is_same_v<T, std::string>) {
+                write<uint32_t>(v.size());
+                write_bytes(v.data(), v.size());
+            } else if constexpr (std::is_same_v<T, InternedString>) {
+                write<std::string>(v.str());
+            } else if constexpr (std::is_same_v<T, Vector>) {
+                write<float>(v.x);
+                write<float>(v.y);
+            } else if constexpr (std::is_pointer_v<T>) {
+                //pointers (Entity::client) do not survive a restart
+            } else {
+                static_assert(std::is_trivially_copyable_v<T>);
+                write_bytes(&v, sizeof(T));
+            }
+        }
+    };
+
+    //reads past the end yield zeroes and set failed
+    class Reader {
+        uint8_t const *at;
+        uint8_t const *end;
+    public:
+        bool failed = false;
+        Reader(uint8_t const *data, size_t size) : at(data), end(data + size) {}
+        void read_bytes(void *bytes, size_t size) {
+            if (static_cast<size_t>(end - at) < size) {
+                failed = true;
+                at = end;
+                std::memset(bytes, 0, size);
+                return;
+            }
+            std::memcpy(bytes, at, size);
+            at += size;
+        }
+        template<typename T>
+        void read(T &v) {
+            if constexpr (std::is_same_v<T, std::string>) {
+                uint32_t size = 0;
+                read<uint32_t>(size);
+                if (static_cast<size_t>(end - at) < size) {
+                    failed = true;
+                    at = end;
+                    v.clear();
+                    return;
+                }
+                v.assign(reinterpret_cast<char const *>(at), size);
+                at += size;
+            } else if constexpr (std::is_same_v<T, InternedString>) {
+                std::string str;
+                read<std::string>(str);
+                v = str;
+            } else if constexpr (std::is_same_v<T, Vector>) {
+                read<float>(v.x);
+                read<float>(v.y);
+            } else if constexpr (std::is_pointer_v<T>) {
+                v = nullptr;
+            } else {
+                static_assert(std::is_trivially_copyable_v<T>);
+                read_bytes(&v, sizeof(T));
+            }
+        }
+    };
+
+    #ifndef WASM_SERVER
+    //socket thread only, between ticks
+    void tick();
+    //restores every game it can from GARDN_SNAPSHOT and starts the rest fresh
+    //returns how many games were restored
+    uint32_t init_games();
+    void save(std::vector<uint8_t> &);
+    #endif
+}
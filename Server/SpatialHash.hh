@@ -1,5 +1,7 @@
 #pragma once
 
+#include <Server/RingSearch.hh>
+
 #include <Shared/Entity.hh>
 #include <Shared/StaticData.hh>
 
@@ -19,10 +21,23 @@ class SpatialHash {
     std::vector<EntityID> cells[MAX_GRID_X][MAX_GRID_Y];
     uint32_t width;
     uint32_t height;
+    template<typename Search>
+    void _ring_search(Search &, SearchPredicate const &);
 public:
+    struct Occupancy {
+        uint32_t occupied_cells;
+        uint32_t max_cell;
+        uint32_t entries;
+    };
     SpatialHash(Simulation *);
     void refresh(uint32_t, uint32_t);
     void insert(Entity const &);
     void collide(std::function<void(Simulation *, Entity &, Entity &)>);
     void query(float, float, float, float, std::function<void(Simulation *, Entity &)>);
+    //closest entity within the distance that passes the predicate, measured to its edge if asked
+    //cells are searched ring by ring outwards, so nearby hits end the search early
+    EntityID nearest(float, float, float, bool, SearchPredicate);
+    //the same, for up to k entities, nearest first
+    std::vector<EntityID> k_nearest(float, float, float, bool, uint32_t, SearchPredicate);
+    Occupancy get_occupancy() const;
 };
\ No newline at end of file
@@ -1,8 +1,11 @@
 #include <Server/SpatialHash.hh>
 
+#include <Server/Trace.hh>
+
 #include <Shared/Simulation.hh>
 #include <Shared/Entity.hh>
 
+#include <algorithm>
 #include <unordered_set>
 
 static uint32_t _hash_two(EntityID const a, EntityID const b) {
@@ -50,6 +53,7 @@ void SpatialHash::collide(std::function<void(Simulation *, Entity &, Entity &)>
 }
 
 void SpatialHash::query(float x, float y, float w, float h, std::function<void(Simulation *, Entity &)> cb) {
+    TRACE_SPAN("spatial_hash_query");
     std::unordered_set<EntityID::id_type> seen_entities;
     uint32_t sx = fclamp(x - w, 0, ARENA_WIDTH - 1) / GRID_SIZE;
     uint32_t sy = fclamp(y - h, 0, ARENA_HEIGHT - 1) / GRID_SIZE;
@@ -70,4 +74,41 @@ void SpatialHash::query(float x, float y, float w, float h, std::function<void(S
             }
         }
     }
+}
+
+//entities are filed under every cell they touch, so no cell is nearer than what it holds
+static float _slack(bool) { return 0; }
+
+template<typename Search>
+void SpatialHash::_ring_search(Search &search, SearchPredicate const &predicate) {
+    ring_search(search.x, search.y, GRID_SIZE, MAX_GRID_X, MAX_GRID_Y, _slack(search.to_edge), [&](uint32_t _x, uint32_t _y) {
+        for (EntityID const &id : cells[_x][_y]) search.consider(simulation, simulation->get_ent(id), predicate);
+    }, [&]() { return search.cutoff(); });
+}
+
+EntityID SpatialHash::nearest(float x, float y, float max_dist, bool to_edge, SearchPredicate predicate) {
+    TRACE_SPAN("spatial_hash_nearest");
+    NearestSearch search(x, y, max_dist, to_edge);
+    _ring_search(search, predicate);
+    return search.best;
+}
+
+std::vector<EntityID> SpatialHash::k_nearest(float x, float y, float max_dist, bool to_edge, uint32_t k, SearchPredicate predicate) {
+    TRACE_SPAN("spatial_hash_nearest");
+    KNearestSearch search(x, y, max_dist, to_edge, k);
+    _ring_search(search, predicate);
+    return search.result();
+}
+
+SpatialHash::Occupancy SpatialHash::get_occupancy() const {
+    Occupancy occupancy = {0, 0, 0};
+    for (uint32_t x = 0; x < MAX_GRID_X; ++x) {
+        for (uint32_t y = 0; y < MAX_GRID_Y; ++y) {
+            uint32_t const size = cells[x][y].size();
+            occupancy.occupied_cells += size > 0;
+            occupancy.max_cell = std::max(occupancy.max_cell, size);
+            occupancy.entries += size;
+        }
+    }
+    return occupancy;
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include <Server/Spawn.hh>
 
 #include <Server/EntityFunctions.hh>
+#include <Server/Journal.hh>
 #include <Server/PetalTracker.hh>
 #include <Server/Server.hh>
 
@@ -10,9 +11,20 @@
 
 #include <cmath>
 
+//MOB_DATA is defined in another file, so these are built on first use
+static InternedString const &_mob_name(MobID::T mob_id) {
+    static std::array<InternedString, MobID::kNumMobs> const MOB_NAMES = [](){
+        std::array<InternedString, MobID::kNumMobs> names;
+        for (MobID::T id = 0; id < MobID::kNumMobs; ++id)
+            names[id] = InternedString::pinned(MOB_DATA[id].name);
+        return names;
+    }();
+    return MOB_NAMES[mob_id];
+}
+
 Entity &alloc_drop(Simulation *sim, PetalID::T drop_id) {
     DEBUG_ONLY(assert(drop_id < PetalID::kNumPetals);)
-    PetalTracker::add_petal(drop_id);
+    PetalTracker::add_petal(sim, drop_id);
     Entity &drop = sim->alloc_ent();
     drop.add_component(kPhysics);
     drop.set_radius(25);
@@ -64,7 +76,7 @@ static Entity &__alloc_mob(
     //mob.score_reward = data.xp;
 
     mob.add_component(kName);
-    mob.set_name(data.name);
+    mob.set_name(_mob_name(mob_id));
 
     mob.base_entity = mob.id;
     if (mob_id == MobID::kDigger) {
@@ -155,7 +167,7 @@ Entity &alloc_petal(Simulation *sim, PetalID::T petal_id, Entity const &parent)
     if (petal_data.attributes.rotation_style == PetalAttributes::kPassiveRot)
         petal.set_angle(frand() * 2 * M_PI);
     petal.mass = petal_data.attributes.mass;
-    petal.friction = DEFAULT_FRICTION * 1.5;
+    petal.friction = PETAL_FRICTION;
     petal.add_component(kRelations);
     petal.set_parent(parent.id);
     petal.set_team(parent.get_team());
@@ -220,10 +232,11 @@ Entity &alloc_dot(Simulation *sim, Entity const &parent) {
 }
 
 Entity &alloc_camera(Simulation *sim, EntityID const team) {
-    ++Server::player_count;
+    sim->camera_count.fetch_add(1, std::memory_order_relaxed);
     Entity &ent = sim->alloc_ent();
     ent.add_component(kCamera);
-    ent.set_recovery_id((static_cast<uint64_t>(std::time(0)) << 32) | std::rand());
+    ent.set_recovery_id(Journal::next_recovery_id());
+    sim->recovery_ids[ent.get_recovery_id()] = ent.id;
     ent.add_component(kRelations);
     if (sim->arena_info.gamemode == Gamemode::kTDM) {
         ent.set_team(team);
@@ -238,10 +251,10 @@ Entity &alloc_camera(Simulation *sim, EntityID const team) {
     ent.set_respawn_level(1);
     for (uint32_t i = 0; i < loadout_slots_at_level(ent.get_respawn_level()); ++i)
         ent.set_inventory(i, PetalID::kBasic);
-    if (frand() < 0.001 && PetalTracker::get_count(PetalID::kUniqueBasic) == 0)
+    if (frand() < 0.001 && PetalTracker::can_grant_unique(sim, PetalID::kUniqueBasic))
         ent.set_inventory(0, PetalID::kUniqueBasic);
     for (uint32_t i = 0; i < 2 * MAX_SLOT_COUNT; ++i)
-        PetalTracker::add_petal(ent.get_inventory(i));
+        PetalTracker::add_petal(sim, ent.get_inventory(i));
     return ent;
 }
 
@@ -265,10 +278,10 @@ Entity &alloc_cpu_camera(Simulation *sim, EntityID const team) {
     for (uint32_t i = 0; i < loadout_slots_at_level(ent.get_respawn_level()); ++i)
         ent.set_inventory(i, inventory[i]);
     
-    if (frand() < 0.001 && PetalTracker::get_count(PetalID::kUniqueBasic) == 0)
+    if (frand() < 0.001 && PetalTracker::can_grant_unique(sim, PetalID::kUniqueBasic))
         ent.set_inventory(0, PetalID::kUniqueBasic);
     for (uint32_t i = 0; i < 2 * MAX_SLOT_COUNT; ++i)
-        PetalTracker::add_petal(ent.get_inventory(i));
+        PetalTracker::add_petal(sim, ent.get_inventory(i));
     return ent;
 }
 
@@ -291,16 +304,17 @@ void player_spawn(Simulation *sim, Entity &camera, Entity &player) {
     player.health = player.max_health = hp_at_level(camera.get_respawn_level());
     for (uint32_t i = 0; i < player.get_loadout_count(); ++i) {
         PetalID::T id = camera.get_inventory(i);
-        LoadoutSlot &slot = player.loadout[i];
+        LoadoutSlot &slot = player.loadout()[i];
         player.set_loadout_ids(i, id);
         slot.update_id(sim, id);
         slot.force_reload();
     }
+    player.loadout_summary().dirty = 1;
 
     for (uint32_t i = player.get_loadout_count(); i < player.get_loadout_count() + MAX_SLOT_COUNT; ++i)
         player.set_loadout_ids(i, camera.get_inventory(i));
     for (uint32_t i = 0; i < MAX_SPONGE_PERIOD; ++i)
-        player.delayed_damage.push_back(0);
+        player.delayed_damage().push_back(0);
 
     //peaceful transfer, no petal tracking needed
     for (uint32_t i = 0; i < MAX_SLOT_COUNT * 2; ++i)
@@ -0,0 +1,108 @@
+#include <Server/StringTable.hh>
+
+#include <array>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+    struct Slot {
+        std::string str;
+        uint32_t refs = 0;
+        uint8_t pinned = 0;
+    };
+
+    //slots never move once handed out, so reads go straight to them without the lock
+    uint32_t const CHUNK_SIZE = 1024;
+    uint32_t const MAX_CHUNKS = 256;
+
+    struct Table {
+        std::mutex mutex;
+        std::array<std::unique_ptr<Slot[]>, MAX_CHUNKS> chunks;
+        //slot 0 is the empty string
+        uint32_t slot_count = 1;
+        std::vector<uint32_t> free_slots;
+        //keys point into the slots
+        std::unordered_map<std::string_view, uint32_t> lookup;
+        Table() { chunks[0].reset(new Slot[CHUNK_SIZE]); }
+    };
+}
+
+//used from static initializers in other files, and never torn down
+static Table &_table() {
+    static Table &table = *new Table;
+    return table;
+}
+
+static Slot &_slot(uint32_t index) {
+    return _table().chunks[index / CHUNK_SIZE][index % CHUNK_SIZE];
+}
+
+//returns 0 (the empty string) if the table is full
+static uint32_t _intern(std::string_view str, uint8_t pin) {
+    if (str.size() == 0) return 0;
+    Table &table = _table();
+    std::lock_guard<std::mutex> lock(table.mutex);
+    auto found = table.lookup.find(str);
+    if (found != table.lookup.end()) {
+        Slot &slot = _slot(found->second);
+        slot.pinned |= pin;
+        if (slot.pinned) return found->second | InternedString::PINNED;
+        ++slot.refs;
+        return found->second;
+    }
+    uint32_t index;
+    if (table.free_slots.size() > 0) {
+        index = table.free_slots.back();
+        table.free_slots.pop_back();
+    } else {
+        if (table.slot_count == CHUNK_SIZE * MAX_CHUNKS) return 0;
+        index = table.slot_count++;
+        if (table.chunks[index / CHUNK_SIZE] == nullptr)
+            table.chunks[index / CHUNK_SIZE].reset(new Slot[CHUNK_SIZE]);
+    }
+    Slot &slot = _slot(index);
+    slot.str = str;
+    slot.refs = 1;
+    slot.pinned = pin;
+    table.lookup.emplace(std::string_view(slot.str), index);
+    return pin ? index | InternedString::PINNED : index;
+}
+
+InternedString::InternedString(std::string_view str) : handle(_intern(str, 0)) {}
+
+InternedString InternedString::pinned(std::string_view str) {
+    InternedString ret;
+    ret.handle = _intern(str, 1);
+    return ret;
+}
+
+void InternedString::_retain(uint32_t h) {
+    std::lock_guard<std::mutex> lock(_table().mutex);
+    ++_slot(h).refs;
+}
+
+void InternedString::_release(uint32_t h) {
+    Table &table = _table();
+    std::lock_guard<std::mutex> lock(table.mutex);
+    Slot &slot = _slot(h);
+    if (--slot.refs > 0 || slot.pinned) return;
+    table.lookup.erase(std::string_view(slot.str));
+    slot.str.clear();
+    slot.str.shrink_to_fit();
+    table.free_slots.push_back(h);
+}
+
+std::string const &InternedString::str() const {
+    static std::string const EMPTY;
+    uint32_t const index = handle & ~PINNED;
+    if (index == 0) return EMPTY;
+    return _slot(index).str;
+}
+
+uint32_t InternedString::count() {
+    Table &table = _table();
+    std::lock_guard<std::mutex> lock(table.mutex);
+    return table.lookup.size();
+}
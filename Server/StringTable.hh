@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+//a string stored once in a process-wide table and passed around as a small handle
+//equal strings share a handle, so comparisons and copies never touch the bytes
+//pinned strings (mob names and other static text) are never freed and skip the
+//refcount entirely, the rest are freed when the last handle goes away
+class InternedString {
+    uint32_t handle;
+    static void _retain(uint32_t);
+    static void _release(uint32_t);
+    static bool counted(uint32_t h) { return h != 0 && (h & PINNED) == 0; }
+    static void retain(uint32_t h) { if (counted(h)) _retain(h); }
+    static void release(uint32_t h) { if (counted(h)) _release(h); }
+public:
+    static uint32_t const PINNED = 1u << 31;
+
+    InternedString() : handle(0) {}
+    InternedString(std::string_view);
+    InternedString(std::string const &str) : InternedString(std::string_view(str)) {}
+    InternedString(char const *str) : InternedString(std::string_view(str)) {}
+    InternedString(InternedString const &other) : handle(other.handle) { retain(handle); }
+    InternedString &operator=(InternedString const &other) {
+        retain(other.handle);
+        release(handle);
+        handle = other.handle;
+        return *this;
+    }
+    ~InternedString() { release(handle); }
+
+    //for text known at startup, intern once and keep around
+    static InternedString pinned(std::string_view);
+
+    bool operator==(InternedString const &other) const {
+        return (handle & ~PINNED) == (other.handle & ~PINNED);
+    }
+    std::string const &str() const;
+    operator std::string const &() const { return str(); }
+    uint32_t size() const { return str().size(); }
+
+    //live strings in the table, for diagnostics
+    static uint32_t count();
+};
@@ -1,5 +1,7 @@
 #include <Server/TeamManager.hh>
 
+#include <Server/Snapshot.hh>
+
 #include <Shared/Simulation.hh>
 
 TeamManager::TeamManager(Simulation *sim) : simulation(sim) {}
@@ -29,9 +31,9 @@ EntityID const TeamManager::get_random_team() const {
 }
 
 void TeamManager::tick() {
-    for (EntityID const team_id : teams)
-        simulation->get_ent(team_id).minimap_dots.clear();
-    simulation->for_each_entity([](Simulation *sim, Entity &ent){
+    for (std::set<EntityID> &dots : minimap_dots)
+        dots.clear();
+    simulation->for_each_entity([&](Simulation *sim, Entity &ent){
         if (!ent.has_component(kDot)) return;
         if (ent.get_color() == ColorID::kGreen) return;
         if (sim->ent_alive(ent.get_parent())) {
@@ -40,7 +42,38 @@ void TeamManager::tick() {
             ent.set_y(player.get_y());
         } else
             sim->request_delete(ent.id);
-        Entity &team = sim->get_ent(ent.get_team());
-        team.minimap_dots.insert(ent.id);
+        for (uint32_t i = 0; i < teams.size(); ++i)
+            if (teams[i] == ent.get_team()) minimap_dots[i].insert(ent.id);
     });
 }
+
+std::set<EntityID> const &TeamManager::get_minimap_dots(EntityID const team_id) const {
+    static std::set<EntityID> const NO_DOTS;
+    for (uint32_t i = 0; i < teams.size(); ++i)
+        if (teams[i] == team_id) return minimap_dots[i];
+    return NO_DOTS;
+}
+
+void TeamManager::save(Snapshot::Writer &writer) const {
+    writer.write<uint32_t>(teams.size());
+    for (EntityID const team_id : teams)
+        writer.write<EntityID>(team_id);
+}
+
+//after the simulation, so the team entities can be checked
+bool TeamManager::load(Snapshot::Reader &reader) {
+    teams.clear();
+    uint32_t count = 0;
+    reader.read<uint32_t>(count);
+    if (count > 4) return false;
+    for (uint32_t i = 0; i < count; ++i) {
+        EntityID team_id;
+        reader.read<EntityID>(team_id);
+        if (reader.failed || !simulation->ent_exists(team_id)) {
+            teams.clear();
+            return false;
+        }
+        teams.push(team_id);
+    }
+    return true;
+}
@@ -5,14 +5,22 @@
 #include <Shared/Entity.hh>
 #include <Shared/StaticDefinitions.hh>
 
+#include <set>
+
 class Simulation;
+namespace Snapshot { class Writer; class Reader; }
 
 class TeamManager {
     StaticArray<EntityID, 4> teams;
+    //rebuilt every tick, by index into teams
+    std::set<EntityID> minimap_dots[4];
     Simulation *simulation;
 public:
     TeamManager(Simulation *);
     void add_team(uint8_t);
     EntityID const get_random_team() const;
     void tick();
+    std::set<EntityID> const &get_minimap_dots(EntityID const) const;
+    void save(Snapshot::Writer &) const;
+    bool load(Snapshot::Reader &);
 };
\ No newline at end of file
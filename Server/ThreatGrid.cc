@@ -0,0 +1,107 @@
+#include <Server/ThreatGrid.hh>
+
+#include <Server/Trace.hh>
+
+#include <Shared/Simulation.hh>
+
+#include <algorithm>
+
+ThreatGrid::ThreatGrid(Simulation *sim) : simulation(sim), max_radius(0) {}
+
+void ThreatGrid::clear() {
+    for (uint32_t x = 0; x < MAX_THREAT_X; ++x) {
+        for (uint32_t y = 0; y < MAX_THREAT_Y; ++y) {
+            wild[x][y].clear();
+            teamed[x][y].clear();
+        }
+    }
+    max_radius = 0;
+}
+
+void ThreatGrid::insert(Entity const &ent) {
+    DEBUG_ONLY(assert(ent.has_component(kRelations));)
+    uint32_t x = fclamp(ent.get_x(), 0, ARENA_WIDTH - 1) / THREAT_CELL_SIZE;
+    uint32_t y = fclamp(ent.get_y(), 0, ARENA_HEIGHT - 1) / THREAT_CELL_SIZE;
+    if (ent.get_team() == NULL_ENTITY) wild[x][y].push_back(ent.id);
+    else teamed[x][y].push_back(ent.id);
+    max_radius = std::max<float>(max_radius, ent.get_radius());
+}
+
+static bool _overlaps(Entity const &ent, float x, float y, float w, float h) {
+    if (ent.get_x() + ent.get_radius() < x - w) return false;
+    if (ent.get_x() - ent.get_radius() > x + w) return false;
+    if (ent.get_y() + ent.get_radius() < y - h) return false;
+    if (ent.get_y() - ent.get_radius() > y + h) return false;
+    return true;
+}
+
+static void _query_cell(Simulation *sim, std::vector<EntityID> const &cell, float x, float y, float w, float h,
+    EntityID const &team, std::function<void(Simulation *, Entity &)> const &cb) {
+    for (EntityID const &id : cell) {
+        Entity &ent = sim->get_ent(id);
+        if (ent.get_team() == team) continue;
+        if (!_overlaps(ent, x, y, w, h)) continue;
+        cb(sim, ent);
+    }
+}
+
+void ThreatGrid::query(float x, float y, float w, float h, EntityID const &team, std::function<void(Simulation *, Entity &)> cb) {
+    TRACE_SPAN("threat_grid_query");
+    uint32_t sx = fclamp(x - w - max_radius, 0, ARENA_WIDTH - 1) / THREAT_CELL_SIZE;
+    uint32_t sy = fclamp(y - h - max_radius, 0, ARENA_HEIGHT - 1) / THREAT_CELL_SIZE;
+    uint32_t ex = fclamp(x + w + max_radius, 0, ARENA_WIDTH - 1) / THREAT_CELL_SIZE;
+    uint32_t ey = fclamp(y + h + max_radius, 0, ARENA_HEIGHT - 1) / THREAT_CELL_SIZE;
+    for (uint32_t _x = sx; _x <= ex; ++_x) {
+        for (uint32_t _y = sy; _y <= ey; ++_y) {
+            if (!teamed[_x][_y].empty())
+                _query_cell(simulation, teamed[_x][_y], x, y, w, h, team, cb);
+            //wild mobs are never enemies of each other
+            if (!(team == NULL_ENTITY) && !wild[_x][_y].empty())
+                _query_cell(simulation, wild[_x][_y], x, y, w, h, team, cb);
+        }
+    }
+}
+
+void ThreatGrid::query_wild(float x, float y, float w, float h, std::function<void(Simulation *, Entity &)> cb) {
+    TRACE_SPAN("threat_grid_query");
+    uint32_t sx = fclamp(x - w - max_radius, 0, ARENA_WIDTH - 1) / THREAT_CELL_SIZE;
+    uint32_t sy = fclamp(y - h - max_radius, 0, ARENA_HEIGHT - 1) / THREAT_CELL_SIZE;
+    uint32_t ex = fclamp(x + w + max_radius, 0, ARENA_WIDTH - 1) / THREAT_CELL_SIZE;
+    uint32_t ey = fclamp(y + h + max_radius, 0, ARENA_HEIGHT - 1) / THREAT_CELL_SIZE;
+    for (uint32_t _x = sx; _x <= ex; ++_x) {
+        for (uint32_t _y = sy; _y <= ey; ++_y) {
+            for (EntityID const &id : wild[_x][_y]) {
+                Entity &ent = simulation->get_ent(id);
+                if (_overlaps(ent, x, y, w, h)) cb(simulation, ent);
+            }
+        }
+    }
+}
+
+//the query rectangle already grows by max_radius, edge distances need the same allowance
+template<typename Search>
+void ThreatGrid::_ring_search(Search &search, EntityID const &team, SearchPredicate const &predicate) {
+    ring_search(search.x, search.y, THREAT_CELL_SIZE, MAX_THREAT_X, MAX_THREAT_Y, search.to_edge ? max_radius : 0,
+    [&](uint32_t _x, uint32_t _y) {
+        for (EntityID const &id : teamed[_x][_y]) {
+            Entity &ent = simulation->get_ent(id);
+            if (!(ent.get_team() == team)) search.consider(simulation, ent, predicate);
+        }
+        if (team == NULL_ENTITY) return;
+        for (EntityID const &id : wild[_x][_y]) search.consider(simulation, simulation->get_ent(id), predicate);
+    }, [&]() { return search.cutoff(); });
+}
+
+EntityID ThreatGrid::nearest(float x, float y, float max_dist, EntityID const &team, bool to_edge, SearchPredicate predicate) {
+    TRACE_SPAN("threat_grid_nearest");
+    NearestSearch search(x, y, max_dist, to_edge);
+    _ring_search(search, team, predicate);
+    return search.best;
+}
+
+std::vector<EntityID> ThreatGrid::k_nearest(float x, float y, float max_dist, EntityID const &team, bool to_edge, uint32_t k, SearchPredicate predicate) {
+    TRACE_SPAN("threat_grid_nearest");
+    KNearestSearch search(x, y, max_dist, to_edge, k);
+    _ring_search(search, team, predicate);
+    return search.result();
+}
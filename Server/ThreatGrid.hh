@@ -0,0 +1,41 @@
+#pragma once
+
+#include <Server/RingSearch.hh>
+
+#include <Shared/Entity.hh>
+#include <Shared/StaticData.hh>
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+class Simulation;
+
+static const uint32_t THREAT_CELL_SIZE = 500;
+static const uint32_t MAX_THREAT_X = div_round_up(ARENA_WIDTH, THREAT_CELL_SIZE);
+static const uint32_t MAX_THREAT_Y = div_round_up(ARENA_HEIGHT, THREAT_CELL_SIZE);
+
+//coarse grid of everything that can be targeted (mobs and flowers), rebuilt
+//every tick next to the spatial hash so enemy searches skip petals, drops and webs
+//wild mobs are kept apart from the rest, a wild mob looking for enemies
+//only ever scans the other list, which is empty away from players
+class ThreatGrid {
+    Simulation *simulation;
+    std::vector<EntityID> wild[MAX_THREAT_X][MAX_THREAT_Y];
+    std::vector<EntityID> teamed[MAX_THREAT_X][MAX_THREAT_Y];
+    //queries are widened by this, so large entities are found from neighboring cells
+    float max_radius;
+    template<typename Search>
+    void _ring_search(Search &, EntityID const &, SearchPredicate const &);
+public:
+    ThreatGrid(Simulation *);
+    void clear();
+    void insert(Entity const &);
+    //every target overlapping the rectangle that is not on the given team
+    void query(float, float, float, float, EntityID const &, std::function<void(Simulation *, Entity &)>);
+    //every wild mob overlapping the rectangle
+    void query_wild(float, float, float, float, std::function<void(Simulation *, Entity &)>);
+    //ring searches like SpatialHash::nearest, skipping the given team
+    EntityID nearest(float, float, float, EntityID const &, bool, SearchPredicate);
+    std::vector<EntityID> k_nearest(float, float, float, EntityID const &, bool, uint32_t, SearchPredicate);
+};
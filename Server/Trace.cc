@@ -0,0 +1,144 @@
+#include <Server/Trace.hh>
+
+#include <Server/Log.hh>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct TraceEvent {
+    char const *name;
+    uint64_t start;
+    uint64_t end;
+};
+
+//each thread appends to its own buffer, the socket thread collects
+//them between ticks when every game and scheduler worker is parked
+struct ThreadBuffer {
+    uint32_t tid;
+    char const *name;
+    std::vector<TraceEvent> events;
+};
+
+struct Capture {
+    std::string path;
+    uint64_t origin;
+    std::vector<ThreadBuffer> threads;
+};
+
+std::atomic<bool> Trace::capturing = false;
+static std::atomic<bool> requested = false;
+static uint32_t capture_ticks = 100;
+static uint32_t ticks_left = 0;
+static uint64_t capture_origin = 0;
+static std::string capture_path;
+
+//never destroyed, the writer thread may outlive static destruction
+static std::mutex &registry_mutex = *new std::mutex;
+static std::vector<ThreadBuffer *> &registry = *new std::vector<ThreadBuffer *>;
+static std::mutex &queue_mutex = *new std::mutex;
+static std::condition_variable &queue_ready = *new std::condition_variable;
+static std::deque<Capture> &queue = *new std::deque<Capture>;
+
+static thread_local ThreadBuffer *local = nullptr;
+static thread_local char const *thread_name = "thread";
+
+static void _write(Capture const &capture) {
+    std::FILE *file = std::fopen(capture.path.c_str(), "w");
+    if (file == nullptr) {
+        Log::info("could not open trace " + capture.path);
+        return;
+    }
+    std::fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", file);
+    char const *separator = "";
+    for (ThreadBuffer const &thread : capture.threads) {
+        std::fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+            separator, thread.tid, thread.name);
+        separator = ",\n";
+        for (TraceEvent const &event : thread.events)
+            std::fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                event.name, thread.tid, (event.start - capture.origin) / 1e3, (event.end - event.start) / 1e3);
+    }
+    std::fputs("\n]}\n", file);
+    std::fclose(file);
+    Log::info("wrote trace " + capture.path);
+}
+
+void Trace::init() {
+    if (char const *ticks = std::getenv("GARDN_TRACE_TICKS"))
+        capture_ticks = std::max(1, std::atoi(ticks));
+    thread_name = "socket";
+    std::thread([](){
+        name_thread("trace writer");
+        while (1) {
+            std::unique_lock<std::mutex> lock(queue_mutex);
+            queue_ready.wait(lock, [](){ return !queue.empty(); });
+            Capture capture = std::move(queue.front());
+            queue.pop_front();
+            lock.unlock();
+            _write(capture);
+        }
+    }).detach();
+}
+
+void Trace::request() {
+    requested.store(true, std::memory_order_relaxed);
+}
+
+void Trace::begin_tick() {
+    if (!requested.exchange(false, std::memory_order_relaxed) || capturing.load(std::memory_order_relaxed)) return;
+    ticks_left = capture_ticks;
+    capture_origin = now();
+    capture_path = "trace-" + std::to_string(std::time(nullptr)) + ".json";
+    Log::info("tracing " + std::to_string(capture_ticks) + " ticks to " + capture_path);
+    //the game threads see this through the semaphore that wakes them
+    capturing.store(true, std::memory_order_relaxed);
+}
+
+void Trace::end_tick() {
+    if (!capturing.load(std::memory_order_relaxed) || --ticks_left > 0) return;
+    capturing.store(false, std::memory_order_relaxed);
+    Capture capture;
+    capture.path = capture_path;
+    capture.origin = capture_origin;
+    {
+        std::lock_guard<std::mutex> lock(registry_mutex);
+        for (ThreadBuffer *buffer : registry) {
+            if (buffer->events.empty()) continue;
+            capture.threads.push_back({buffer->tid, buffer->name, {}});
+            capture.threads.back().events.swap(buffer->events);
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        queue.push_back(std::move(capture));
+    }
+    queue_ready.notify_one();
+}
+
+void Trace::name_thread(char const *name) {
+    thread_name = name;
+    if (local != nullptr) local->name = name;
+}
+
+uint64_t Trace::now() {
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+void Trace::record(char const *name, uint64_t start, uint64_t end) {
+    if (local == nullptr) {
+        std::lock_guard<std::mutex> lock(registry_mutex);
+        local = new ThreadBuffer{static_cast<uint32_t>(registry.size() + 1), thread_name, {}};
+        registry.push_back(local);
+    }
+    local->events.push_back({name, start, end});
+}
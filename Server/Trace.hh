@@ -0,0 +1,36 @@
+#pragma once
+
+//chrome trace-event capture of the next few ticks, started at runtime with SIGUSR1
+//spans cost a relaxed load while no capture is running
+#ifndef WASM_SERVER
+#include <atomic>
+#include <cstdint>
+
+namespace Trace {
+    extern std::atomic<bool> capturing;
+
+    void init();
+    //async-signal-safe, the capture starts with the next tick
+    void request();
+    //socket thread only, around Server::tick
+    void begin_tick();
+    void end_tick();
+    void name_thread(char const *);
+    uint64_t now();
+    void record(char const *, uint64_t, uint64_t);
+
+    class Span {
+        char const *name;
+        uint64_t start;
+    public:
+        Span(char const *n) : name(n), start(capturing.load(std::memory_order_relaxed) ? now() : 0) {}
+        ~Span() { if (start != 0) record(name, start, now()); }
+    };
+}
+
+#define _TRACE_SPAN_NAME(line) _trace_span_##line
+#define _TRACE_SPAN(name, line) Trace::Span _TRACE_SPAN_NAME(line)(name)
+#define TRACE_SPAN(name) _TRACE_SPAN(name, __LINE__)
+#else
+#define TRACE_SPAN(name)
+#endif
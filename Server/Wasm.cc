@@ -1,12 +1,13 @@
 #ifdef WASM_SERVER
 #include <Server/Client.hh>
+#include <Server/Journal.hh>
+#include <Server/Log.hh>
 #include <Server/PetalTracker.hh>
 #include <Server/Server.hh>
 
 #include <Shared/Config.hh>
 #include <Shared/Map.hh>
 
-#include <iostream>
 #include <string>
 #include <unordered_map>
 
@@ -19,18 +20,19 @@ static uint8_t INCOMING_BUFFER[MAX_BUFFER_LEN] = {0};
 
 extern "C" {
     void on_connect(int ws_id) {
-        std::printf("client connect: [%d]\n", ws_id);
+        Log::write(Log::kConnect, { .value = static_cast<double>(ws_id) });
         WebSocket *ws = new WebSocket(ws_id);
         WS_MAP.insert({ws_id, ws});
+        Journal::record_connect(&ws->client);
     }
 
     void on_disconnect(int ws_id, int reason) {
         auto iter = WS_MAP.find(ws_id);
         if (iter == WS_MAP.end()) {
-            std::printf("unknown ws disconnect: [%d]", ws_id);
+            Log::write(Log::kDisconnect, { .text = "unknown socket", .value = static_cast<double>(ws_id) });
             return;
         }
-        std::printf("client disconnect: [%d]\n", ws_id);
+        Log::write(Log::kDisconnect, { .text = "socket", .value = static_cast<double>(ws_id) });
         Client::on_disconnect(iter->second, reason, {});
         delete iter->second;
         WS_MAP.erase(ws_id);
@@ -58,6 +60,7 @@ extern "C" {
         if (id >= ENTITY_CAP) return false;
         EntityID player_id = EntityID(id, hash);
         if (!sim->ent_alive(player_id)) return false;
+        RngScope rng_scope(sim->rng);
         Entity &player = sim->get_ent(player_id);
         if (!player.has_component(kFlower) || player.has_component(kMob)) return false;
         uint32_t loadout_count = loadout_slots_at_level(score_to_level(score));
@@ -74,22 +77,23 @@ extern "C" {
             player.set_x(0.99 * zone.left + 0.01 * zone.right);
         }
         for (uint32_t i = 0; i < 2 * MAX_SLOT_COUNT; ++i) {
-            PetalTracker::remove_petal(player.get_loadout_ids(i));
+            PetalTracker::remove_petal(sim, player.get_loadout_ids(i));
             player.set_loadout_ids(i, PetalID::kNone);
         }
         for (uint32_t i = 0; i < MAX_SLOT_COUNT; ++i) {
-            LoadoutSlot &slot = player.loadout[i];
+            LoadoutSlot &slot = player.loadout()[i];
             slot.update_id(sim, PetalID::kNone);
         }
         for (uint32_t i = 0; i < loadout_count + MAX_SLOT_COUNT; ++i) {
             player.set_loadout_ids(i, loadout_ids[i]);
-            PetalTracker::add_petal(loadout_ids[i]);
+            PetalTracker::add_petal(sim, loadout_ids[i]);
         }
         for (uint32_t i = 0; i < loadout_count; ++i) {
-            LoadoutSlot &slot = player.loadout[i];
+            LoadoutSlot &slot = player.loadout()[i];
             slot.update_id(sim, loadout_ids[i]);
             slot.force_reload();
         }
+        player.loadout_summary().dirty = 1;
         return true;
     }
 }
@@ -168,6 +172,7 @@ void Server::init() {
     });
 
     for (GameInstance &game : Server::games) game.init();
+    Journal::init(false);
     Server::run();
 }
 
@@ -179,7 +184,7 @@ void Server::run() {
 
 void Server::stop() {
     Server::is_stopping = true;
-    std::cout << "stopping...\n";
+    Log::info("stopping...");
     EM_ASM({
         Module.server.close();
         for (const ws_id in Module.ws_connections) {
@@ -5,6 +5,10 @@
 #include <Helpers/Bits.hh>
 #include <Helpers/Macros.hh>
 
+#ifdef SERVERSIDE
+#include <Server/Bandwidth.hh>
+#endif
+
 Arena::Arena() {
     init();
 }
@@ -47,23 +51,23 @@ FIELDS_Arena
 
 void Arena::write(Writer *writer, uint8_t create) {
     if (create) {
-        #define SINGLE(name, type) writer->write<type>(name);
-        #define MULTIPLE(name, type, count) for (uint32_t i = 0; i < count; ++i) writer->write<type>(name[i]);
+        #define SINGLE(name, type) RECORD_BANDWIDTH(arena, k##name, 1, writer, writer->write<type>(name);)
+        #define MULTIPLE(name, type, count) RECORD_BANDWIDTH(arena, k##name, 1, writer, for (uint32_t i = 0; i < count; ++i) writer->write<type>(name[i]);)
         FIELDS_Arena
         #undef SINGLE
         #undef MULTIPLE
     } else {
-#define SINGLE(name, type) if(BitMath::at_arr(state, k##name)) { writer->write<uint8_t>(k##name); writer->write<type>(name); }
-#define MULTIPLE(name, type, amt) if(BitMath::at_arr(state, k##name)) { \
+#define SINGLE(name, type) if(BitMath::at_arr(state, k##name)) RECORD_BANDWIDTH(arena, k##name, 0, writer, writer->write<uint8_t>(k##name); writer->write<type>(name);)
+#define MULTIPLE(name, type, amt) if(BitMath::at_arr(state, k##name)) RECORD_BANDWIDTH(arena, k##name, 0, writer, \
     writer->write<uint8_t>(k##name); \
     for (uint32_t n = 0; n < amt; ++n) \
         if (BitMath::at_arr(state_per_##name, n)) { writer->write<uint8_t>(n); writer->write<type>(name[n]); } \
         writer->write<uint8_t>(amt); \
-    }
+    )
 FIELDS_Arena
 #undef SINGLE
 #undef MULTIPLE
-    writer->write<uint8_t>(kFieldCount);
+    RECORD_BANDWIDTH(overhead, Bandwidth::kFieldHeader, 0, writer, writer->write<uint8_t>(kFieldCount);)
     }
 }
 #else
@@ -17,7 +17,7 @@ CLIENT_ONLY(typedef LerpFloat Float;)
     SINGLE(player_count, uint32_t) \
     SINGLE(gamemode, uint8_t) \
     MULTIPLE(scores, float, LEADERBOARD_SIZE) \
-    MULTIPLE(names, std::string, LEADERBOARD_SIZE) \
+    MULTIPLE(names, String, LEADERBOARD_SIZE) \
     MULTIPLE(colors, uint8_t, LEADERBOARD_SIZE)
 
 class Arena {
@@ -88,6 +88,14 @@ void Writer::Encoder<std::string>::write(Writer &w, std::string const &str) {
     for (uint32_t i = 0; i < len; ++i) w.write<uint8_t>(str[i]);
 }
 
+#ifdef SERVERSIDE
+//same bytes as std::string, only sent when the field is created or changes handle
+template<>
+void Writer::Encoder<InternedString>::write(Writer &w, InternedString const &str) {
+    w.write<std::string>(str.str());
+}
+#endif
+
 Reader::Reader(uint8_t const *buf) : at(buf), packet(buf) {}
 
 uint8_t Reader::next() {
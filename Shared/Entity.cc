@@ -3,9 +3,27 @@
 #include <Shared/Binary.hh>
 #include <Shared/StaticData.hh>
 
+#ifdef SERVERSIDE
+#include <Server/Bandwidth.hh>
+#include <Server/Snapshot.hh>
+#endif
+
 #include <Shared/Binary.hh>
 
+#ifdef SERVERSIDE
+#include <Helpers/Pool.hh>
+
+#define POOLED(component) \
+    static component##Block EMPTY_##component; \
+    static BlockPool<component##Block> POOL_##component;
+PERPOOLED
+#undef POOLED
+#endif
+
 Entity::Entity() {
+    #define POOLED(component) pooled_##component = &EMPTY_##component;
+    PERPOOLED
+    #undef POOLED
     init();
 }
 
@@ -13,11 +31,19 @@ void Entity::init() {
     components = 0;
     pending_delete = 0;
     lifetime = 0;
-    #define SINGLE(component, name, type) name = {};
-    #define MULTIPLE(component, name, type, amt) for (uint32_t n = 0; n < amt; ++n) { name[n] = {}; }
+    #define SINGLE(component, name, type) STORAGE_##component(name = {};,)
+    #define MULTIPLE(component, name, type, amt) STORAGE_##component(for (uint32_t n = 0; n < amt; ++n) { name[n] = {}; },)
     PERFIELD
     #undef SINGLE
     #undef MULTIPLE
+    //pooled blocks are reset as they go back
+    #define POOLED(component) \
+        if (pooled_##component != &EMPTY_##component) { \
+            POOL_##component.release(pooled_##component); \
+            pooled_##component = &EMPTY_##component; \
+        }
+    PERPOOLED
+    #undef POOLED
     #define SINGLE(name, type, reset) name reset;
     #define MULTIPLE(name, type, amt, reset) for (uint32_t i = 0; i < amt; ++i) { name[i] reset; }
     PER_EXTRA_FIELD
@@ -27,7 +53,9 @@ void Entity::init() {
 }
 
 void Entity::reset_protocol() {
-    for (uint32_t n = 0; n < div_round_up(kFieldCount, 8); ++n) state[n] = 0;
+    #define COMPONENT(name) for (uint32_t n = 0; n < sizeof(state_##name); ++n) state_##name[n] = 0;
+    PERCOMPONENT
+    #undef COMPONENT
     #define SINGLE(component, name, type);
     #define MULTIPLE(component, name, type, amt); for (uint32_t n = 0; n < div_round_up(amt, 8); ++n) { state_per_##name[n] = 0; }
     PERFIELD
@@ -38,6 +66,9 @@ void Entity::reset_protocol() {
 void Entity::add_component(uint32_t comp) {
     DEBUG_ONLY(assert(!has_component(comp));)
     BitMath::set(components, comp);
+    #define POOLED(component) if (comp == k##component) pooled_##component = POOL_##component.acquire();
+    PERPOOLED
+    #undef POOLED
 }
 
 uint8_t Entity::has_component(uint32_t comp) const {
@@ -47,48 +78,67 @@ uint8_t Entity::has_component(uint32_t comp) const {
 #define SINGLE(component, name, type) \
 type const &Entity::get_##name() const { \
     DEBUG_ONLY(assert(has_component(k##component));) \
-    return name; \
+    return ENTITY_FIELD(component, name); \
 }
 #define MULTIPLE(component, name, type, amt) \
 type const &Entity::get_##name(uint32_t i) const { \
     DEBUG_ONLY(assert(has_component(k##component));) \
     DEBUG_ONLY(assert(i < amt);) \
-    return name[i]; \
+    return ENTITY_FIELD(component, name)[i]; \
 }
 PERFIELD
 #undef SINGLE
 #undef MULTIPLE
 
 #ifdef SERVERSIDE
+//never write into the shared empty block of a component the entity lacks
+#define _SKIP_IF_EMPTY(component) \
+    STORAGE_##component(, if (pooled_##component == &EMPTY_##component) return;)
 #define SINGLE(component, name, type) \
 void Entity::set_##name(type const &v) { \
     DEBUG_ONLY(assert(has_component(k##component));) \
-    if (name == v) return; \
-    name = v; \
-    BitMath::set_arr(state, k##name); \
+    _SKIP_IF_EMPTY(component) \
+    if (ENTITY_FIELD(component, name) == v) return; \
+    ENTITY_FIELD(component, name) = v; \
+    BitMath::set_arr(state_##component, kBit_##name); \
 }
 #define MULTIPLE(component, name, type, amt) \
 void Entity::set_##name(uint32_t i, type const &v) { \
     DEBUG_ONLY(assert(has_component(k##component));) \
     DEBUG_ONLY(assert(i < amt);) \
-    if (name[i] == v) return; \
-    name[i] = v; \
-    BitMath::set_arr(state, k##name); \
+    _SKIP_IF_EMPTY(component) \
+    if (ENTITY_FIELD(component, name)[i] == v) return; \
+    ENTITY_FIELD(component, name)[i] = v; \
+    BitMath::set_arr(state_##component, kBit_##name); \
     BitMath::set_arr(state_per_##name, i); \
 }
 PERFIELD
 #undef SINGLE
 #undef MULTIPLE
+#undef _SKIP_IF_EMPTY
+
+#define SINGLE(component, name, type) \
+void Entity::set_state_##name(uint8_t v) { \
+    DEBUG_ONLY(assert(has_component(k##component));) \
+    if (v) BitMath::set_arr(state_##component, kBit_##name); \
+    else BitMath::unset_arr(state_##component, kBit_##name); \
+}
+#define MULTIPLE(component, name, type, amt)
+PERFIELD
+#undef SINGLE
+#undef MULTIPLE
 
 template<>
 void Entity::write<true>(Writer *writer) {
-    writer->write<uint32_t>(components);
-    writer->write<uint32_t>(lifetime);
-    #define SINGLE(component, name, type) { writer->write<type>(name); }
-    #define MULTIPLE(component, name, type, amt) { \
+    RECORD_BANDWIDTH(overhead, Bandwidth::kFieldHeader, 1, writer,
+        writer->write<uint32_t>(components);
+        writer->write<uint32_t>(lifetime);
+    )
+    #define SINGLE(component, name, type) RECORD_BANDWIDTH(entity, k##name, 1, writer, writer->write<type>(ENTITY_FIELD(component, name));)
+    #define MULTIPLE(component, name, type, amt) RECORD_BANDWIDTH(entity, k##name, 1, writer, \
         for (uint32_t n = 0; n < amt; ++n) \
-            writer->write<type>(name[n]); \
-    }
+            writer->write<type>(ENTITY_FIELD(component, name)[n]); \
+    )
     #define COMPONENT(name) if (has_component(k##name)) { FIELDS_##name }
     PERCOMPONENT
     #undef SINGLE
@@ -99,42 +149,103 @@ void Entity::write<true>(Writer *writer) {
 template<>
 void Entity::write<false>(Writer *writer) {
     #define SINGLE(component, name, type) \
-        if(BitMath::at_arr(state, k##name)) { \
+        if(BitMath::at_arr(state_##component, kBit_##name)) RECORD_BANDWIDTH(entity, k##name, 0, writer, \
             writer->write<uint8_t>(k##name); \
-            writer->write<type>(name); \
-    }
+            writer->write<type>(ENTITY_FIELD(component, name)); \
+    )
     #define MULTIPLE(component, name, type, amt) \
-        if(BitMath::at_arr(state, k##name)) { \
+        if(BitMath::at_arr(state_##component, kBit_##name)) RECORD_BANDWIDTH(entity, k##name, 0, writer, \
             writer->write<uint8_t>(k##name); \
             for (uint32_t n = 0; n < amt; ++n) { \
                 if (BitMath::at_arr(state_per_##name, n)) { \
                     writer->write<uint8_t>(n); \
-                    writer->write<type>(name[n]); \
+                    writer->write<type>(ENTITY_FIELD(component, name)[n]); \
                 } \
             } \
             writer->write<uint8_t>(amt); \
-        }
+        )
     #define COMPONENT(name) if (has_component(k##name)) { FIELDS_##name }
     PERCOMPONENT
     #undef SINGLE
     #undef MULTIPLE
     #undef COMPONENT
-    writer->write<uint8_t>(kFieldCount);
+    RECORD_BANDWIDTH(overhead, Bandwidth::kFieldHeader, 0, writer, writer->write<uint8_t>(kFieldCount);)
 }
 
 void Entity::write(Writer *writer, uint8_t create) {
     if (create) write<true>(writer);
     else write<false>(writer);
 }
+
+//everything except the protocol state, which is reset for a fresh start anyway
+void Entity::save(Snapshot::Writer &writer) const {
+    writer.write<uint32_t>(components);
+    writer.write<uint32_t>(lifetime);
+    writer.write<uint8_t>(pending_delete);
+    #define SINGLE(component, name, type) writer.write<type>(ENTITY_FIELD(component, name));
+    #define MULTIPLE(component, name, type, amt) \
+        for (uint32_t n = 0; n < amt; ++n) \
+            writer.write<type>(ENTITY_FIELD(component, name)[n]);
+    #define COMPONENT(name) if (has_component(k##name)) { FIELDS_##name }
+    PERCOMPONENT
+    #undef SINGLE
+    #undef MULTIPLE
+    #undef COMPONENT
+    #define SINGLE(name, type, reset) writer.write<type>(name);
+    #define MULTIPLE(name, type, amt, reset) \
+        for (uint32_t n = 0; n < amt; ++n) \
+            writer.write<type>(name[n]);
+    PER_EXTRA_FIELD
+    #undef SINGLE
+    #undef MULTIPLE
+    if (has_component(kFlower)) {
+        for (uint32_t n = 0; n < MAX_SLOT_COUNT; ++n)
+            writer.write<LoadoutSlot>(pooled_Flower->loadout[n]);
+        writer.write<deleted_petals_t>(pooled_Flower->deleted_petals);
+        writer.write<delayed_damage_t>(pooled_Flower->delayed_damage);
+    }
+}
+
+void Entity::load(Snapshot::Reader &reader) {
+    init();
+    reader.read<uint32_t>(components);
+    reader.read<uint32_t>(lifetime);
+    reader.read<uint8_t>(pending_delete);
+    #define POOLED(component) if (has_component(k##component)) pooled_##component = POOL_##component.acquire();
+    PERPOOLED
+    #undef POOLED
+    #define SINGLE(component, name, type) reader.read<type>(ENTITY_FIELD(component, name));
+    #define MULTIPLE(component, name, type, amt) \
+        for (uint32_t n = 0; n < amt; ++n) \
+            reader.read<type>(ENTITY_FIELD(component, name)[n]);
+    #define COMPONENT(name) if (has_component(k##name)) { FIELDS_##name }
+    PERCOMPONENT
+    #undef SINGLE
+    #undef MULTIPLE
+    #undef COMPONENT
+    #define SINGLE(name, type, reset) reader.read<type>(name);
+    #define MULTIPLE(name, type, amt, reset) \
+        for (uint32_t n = 0; n < amt; ++n) \
+            reader.read<type>(name[n]);
+    PER_EXTRA_FIELD
+    #undef SINGLE
+    #undef MULTIPLE
+    if (has_component(kFlower)) {
+        for (uint32_t n = 0; n < MAX_SLOT_COUNT; ++n)
+            reader.read<LoadoutSlot>(pooled_Flower->loadout[n]);
+        reader.read<deleted_petals_t>(pooled_Flower->deleted_petals);
+        reader.read<delayed_damage_t>(pooled_Flower->delayed_damage);
+    }
+}
 #else
 
 template<>
 void Entity::read<true>(Reader *reader) {
     components = reader->read<uint32_t>();
     lifetime = reader->read<uint32_t>();
-    #define SINGLE(component, name, type) { reader->read<type>(name); BitMath::set_arr(state, k##name); }
+    #define SINGLE(component, name, type) { reader->read<type>(name); BitMath::set_arr(state_##component, kBit_##name); }
     #define MULTIPLE(component, name, type, amt) { \
-        BitMath::set_arr(state, k##name); \
+        BitMath::set_arr(state_##component, kBit_##name); \
         for (uint32_t n = 0; n < amt; ++n) { \
             BitMath::set_arr(state_per_##name, n); \
             reader->read<type>(name[n]); \
@@ -155,11 +266,11 @@ void Entity::read<false>(Reader *reader) {
             case kFieldCount: { return; }
             #define SINGLE(component, name, type) case k##name: { \
                 reader->read<type>(name); \
-                BitMath::set_arr(state, k##name); \
+                BitMath::set_arr(state_##component, kBit_##name); \
                 break; \
             }
             #define MULTIPLE(component, name, type, amt) case k##name: { \
-                BitMath::set_arr(state, k##name); \
+                BitMath::set_arr(state_##component, kBit_##name); \
                 while (1) { \
                     uint8_t index = reader->read<uint8_t>(); \
                     if (index >= amt) break; \
@@ -183,7 +294,7 @@ void Entity::read(Reader *reader, uint8_t create) {
 #define SINGLE(component, name, type) \
 uint8_t Entity::get_state_##name() const { \
     DEBUG_ONLY(assert(has_component(k##component));) \
-    return BitMath::at_arr(state, k##name); \
+    return BitMath::at_arr(state_##component, kBit_##name); \
 }
 
 #define MULTIPLE(component, name, type, amt) \
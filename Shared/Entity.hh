@@ -7,12 +7,14 @@
 #include <Helpers/Macros.hh>
 #include <Helpers/Vector.hh>
 
+#include <algorithm>
 #include <cstdint>
 
 typedef CircularArray<PetalID::T, MAX_SLOT_COUNT> deleted_petals_t;
 typedef CircularArray<float, MAX_SPONGE_PERIOD> delayed_damage_t;
 
 SERVER_ONLY(class Writer;)
+SERVER_ONLY(namespace Snapshot { class Writer; class Reader; })
 CLIENT_ONLY(class Reader;)
 
 SERVER_ONLY(typedef uint8_t StickyFlag;)
@@ -21,6 +23,28 @@ CLIENT_ONLY(typedef PersistentFlag StickyFlag;)
 SERVER_ONLY(typedef float Float;)
 CLIENT_ONLY(typedef LerpFloat Float;)
 
+#ifdef SERVERSIDE
+#define SINGLE(component, name, type) type name;
+#define MULTIPLE(component, name, type, amt) type name[amt];
+#define POOLED(component) struct component##Block { FIELDS_##component POOLED_EXTRA_##component };
+//server bookkeeping that only flowers use rides along with the Flower block
+#define POOLED_EXTRA_Camera
+#define POOLED_EXTRA_Flower \
+    LoadoutSlot loadout[MAX_SLOT_COUNT]; \
+    deleted_petals_t deleted_petals; \
+    delayed_damage_t delayed_damage; \
+    LoadoutSummary loadout_summary;
+#define POOLED_EXTRA_Name
+#define POOLED_EXTRA_Chat
+PERPOOLED
+#undef SINGLE
+#undef MULTIPLE
+#undef POOLED
+#endif
+
+//a component field from inside Entity, wherever STORAGE_ puts it
+#define ENTITY_FIELD(component, name) STORAGE_##component(name, pooled_##component->name)
+
 enum Components {
     #define COMPONENT(name) k##name,
     PERCOMPONENT
@@ -38,12 +62,27 @@ class Entity {
         kFieldCount
     };
     uint32_t components;
-#define SINGLE(component, name, type) type name;
-#define MULTIPLE(component, name, type, amt) type name[amt];
+#define SINGLE(component, name, type) STORAGE_##component(type name;,)
+#define MULTIPLE(component, name, type, amt) STORAGE_##component(type name[amt];,)
     PERFIELD
 #undef SINGLE
 #undef MULTIPLE
-    uint8_t state[div_round_up(kFieldCount, 8)];
+    //absent components all point at one shared, read-only empty block
+#define POOLED(component) component##Block *pooled_##component;
+    PERPOOLED
+#undef POOLED
+    //dirty bits, one set per component so that systems writing different
+    //components of the same entity never write the same byte
+#define SINGLE(component, name, type) kBit_##name,
+#define MULTIPLE(component, name, type, amt) kBit_##name,
+#define COMPONENT(name) enum name##Bits { FIELDS_##name k##name##BitCount };
+    PERCOMPONENT
+#undef COMPONENT
+#undef SINGLE
+#undef MULTIPLE
+#define COMPONENT(name) uint8_t state_##name[std::max(1u, div_round_up(k##name##BitCount, 8))];
+    PERCOMPONENT
+#undef COMPONENT
 #define SINGLE(component, name, type);
 #define MULTIPLE(component, name, type, amt) uint8_t state_per_##name[div_round_up(amt, 8)];
     PERFIELD
@@ -75,17 +114,40 @@ public:
 #undef MULTIPLE
 
 #ifdef SERVERSIDE
+    LoadoutSlot *loadout() { DEBUG_ONLY(assert(has_component(kFlower));) return pooled_Flower->loadout; }
+    deleted_petals_t &deleted_petals() { DEBUG_ONLY(assert(has_component(kFlower));) return pooled_Flower->deleted_petals; }
+    deleted_petals_t const &deleted_petals() const { DEBUG_ONLY(assert(has_component(kFlower));) return pooled_Flower->deleted_petals; }
+    delayed_damage_t &delayed_damage() { DEBUG_ONLY(assert(has_component(kFlower));) return pooled_Flower->delayed_damage; }
+    //use get_loadout_summary to read it, this is for marking it dirty
+    LoadoutSummary &loadout_summary() { DEBUG_ONLY(assert(has_component(kFlower));) return pooled_Flower->loadout_summary; }
+
     void write(Writer *, uint8_t);
 
     template<bool>
     void write(Writer *);
+    void save(Snapshot::Writer &) const;
+    void load(Snapshot::Reader &);
 #define SINGLE(component, name, type) void set_##name(type const &);
 #define MULTIPLE(component, name, type, amt) void set_##name(uint32_t, type const &);
     PERFIELD
 #undef SINGLE
+#undef MULTIPLE
+    //puts a field in or keeps it out of the next update without touching its value
+#define SINGLE(component, name, type) void set_state_##name(uint8_t);
+#define MULTIPLE(component, name, type, amt)
+    PERFIELD
+#undef SINGLE
 #undef MULTIPLE
 #else
     void tick_lerp(float);
+#ifdef ORBIT_PREDICTION
+    void predict_orbit(Entity const &);
+    void apply_orbit_prediction();
+#endif
+#ifdef DEAD_RECKONING
+    void reckon();
+    void apply_reckoning();
+#endif
     void read(Reader *, uint8_t);
 
     template<bool>
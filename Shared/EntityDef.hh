@@ -4,9 +4,18 @@
 
 #include <cstdint>
 #include <set>
+#include <string>
+
+#ifdef SERVERSIDE
+#include <Server/StringTable.hh>
+#endif
 
 class Client;
 
+//text fields are interned on the server and plain strings on the client
+SERVER_ONLY(typedef InternedString String;)
+CLIENT_ONLY(typedef std::string String;)
+
 typedef uint16_t game_tick_t;
 
 #define PERCOMPONENT \
@@ -53,7 +62,7 @@ SINGLE(Physics, angle, Float)
 SINGLE(Camera, player, EntityID) \
 SINGLE(Camera, respawn_level, uint8_t) \
 MULTIPLE(Camera, inventory, PetalID::T, 2 * MAX_SLOT_COUNT) \
-SINGLE(Camera, killed_by, std::string) \
+SINGLE(Camera, killed_by, String) \
 SINGLE(Camera, camera_x, Float) \
 SINGLE(Camera, camera_y, Float) \
 SINGLE(Camera, fov, Float) \
@@ -72,11 +81,28 @@ SINGLE(Flower, face_flags, uint8_t) \
 SINGLE(Flower, equip_flags, uint8_t) \
 SINGLE(Flower, leaderboard_pos, uint8_t) \
 MULTIPLE(Flower, loadout_ids, PetalID::T, 2 * MAX_SLOT_COUNT) \
-MULTIPLE(Flower, loadout_reloads, float, MAX_SLOT_COUNT)
+MULTIPLE(Flower, loadout_reloads, float, MAX_SLOT_COUNT) \
+ORBIT_FIELDS_Flower
 
 #define FIELDS_Petal \
 SINGLE(Petal, petal_id, PetalID::T) \
-SINGLE(Petal, petal_flags, uint8_t)
+SINGLE(Petal, petal_flags, uint8_t) \
+ORBIT_FIELDS_Petal
+
+//the orbit clients need to move petals themselves, see Shared/Orbit.hh
+#ifdef ORBIT_PREDICTION
+#define ORBIT_FIELDS_Flower \
+SINGLE(Flower, orbit_heading, float) \
+SINGLE(Flower, orbit_range, float)
+#define ORBIT_FIELDS_Petal \
+SINGLE(Petal, orbit_slot, float) \
+SINGLE(Petal, orbit_member, uint8_t) \
+SINGLE(Petal, orbit_vx, float) \
+SINGLE(Petal, orbit_vy, float)
+#else
+#define ORBIT_FIELDS_Flower
+#define ORBIT_FIELDS_Petal
+#endif
 
 #define FIELDS_Health \
 SINGLE(Health, health_ratio, Float) \
@@ -85,7 +111,21 @@ SINGLE(Health, damaged, StickyFlag) \
 SINGLE(Health, revived, StickyFlag)
 
 #define FIELDS_Mob \
-SINGLE(Mob, mob_id, MobID::T)
+SINGLE(Mob, mob_id, MobID::T) \
+RECKONING_FIELDS_Mob
+
+//the motion clients extrapolate mobs with, see Shared/Reckoning.hh
+#ifdef DEAD_RECKONING
+#define RECKONING_FIELDS_Mob \
+SINGLE(Mob, motion_vx, float) \
+SINGLE(Mob, motion_vy, float) \
+SINGLE(Mob, motion_ax, float) \
+SINGLE(Mob, motion_ay, float) \
+SINGLE(Mob, motion_jx, float) \
+SINGLE(Mob, motion_jy, float)
+#else
+#define RECKONING_FIELDS_Mob
+#endif
 
 #define FIELDS_Drop \
 SINGLE(Drop, drop_id, PetalID::T) \
@@ -101,17 +141,63 @@ SINGLE(Segmented, seg_tail, EntityID)
 SINGLE(Score, score, uint32_t)
 
 #define FIELDS_Name \
-SINGLE(Name, name, std::string) \
+SINGLE(Name, name, String) \
 SINGLE(Name, nametag_visible, uint8_t)
 
 #define FIELDS_Chat \
-SINGLE(Chat, text, std::string)
+SINGLE(Chat, text, String)
 
 #define FIELDS_Dot
 
 #define FIELDS_Animation \
 SINGLE(Animation, anim_type, uint8_t)
 
+//what the verify packet carries instead of the bare VERSION_HASH: the replicated field lists
+//are mixed in, so a client and server that disagree on ORBIT_PREDICTION or DEAD_RECKONING
+//reject each other as outdated instead of misreading every field after the first difference
+uint64_t const PROTOCOL_HASH = VERSION_HASH ^ fnv1a(
+    #define COMPONENT(name) #name ","
+    PERCOMPONENT
+    #undef COMPONENT
+    #define SINGLE(component, name, type) #component "." #name ":" #type ";"
+    #define MULTIPLE(component, name, type, amt) #component "." #name ":" #type "[" #amt "];"
+    PERFIELD
+    #undef SINGLE
+    #undef MULTIPLE
+);
+
+//where each component's fields live: petals, mobs and drops make up most of the
+//entity array on the server, so components they never carry go in pooled blocks
+//and the entity only keeps a pointer to them
+#define INLINE_STORAGE(in_entity, in_block) in_entity
+#ifdef SERVERSIDE
+#define POOLED_STORAGE(in_entity, in_block) in_block
+#define PERPOOLED \
+    POOLED(Camera) \
+    POOLED(Flower) \
+    POOLED(Name) \
+    POOLED(Chat)
+#else
+#define POOLED_STORAGE(in_entity, in_block) in_entity
+#define PERPOOLED
+#endif
+
+#define STORAGE_Physics INLINE_STORAGE
+#define STORAGE_Camera POOLED_STORAGE
+#define STORAGE_Relations INLINE_STORAGE
+#define STORAGE_Flower POOLED_STORAGE
+#define STORAGE_Petal INLINE_STORAGE
+#define STORAGE_Health INLINE_STORAGE
+#define STORAGE_Mob INLINE_STORAGE
+#define STORAGE_Drop INLINE_STORAGE
+#define STORAGE_Segmented INLINE_STORAGE
+#define STORAGE_Web INLINE_STORAGE
+#define STORAGE_Score INLINE_STORAGE
+#define STORAGE_Name POOLED_STORAGE
+#define STORAGE_Chat POOLED_STORAGE
+#define STORAGE_Dot INLINE_STORAGE
+#define STORAGE_Animation INLINE_STORAGE
+
 #ifdef SERVERSIDE
 #define PER_EXTRA_FIELD \
     SINGLE(velocity, Vector, .set(0,0)) \
@@ -121,7 +207,6 @@ SINGLE(Animation, anim_type, uint8_t)
     SINGLE(mass, float, =1) \
     SINGLE(speed_ratio, float, =1) \
     \
-    MULTIPLE(loadout, LoadoutSlot, MAX_SLOT_COUNT, .reset()) \
     SINGLE(heading_angle, float, =0) \
     SINGLE(player_count, uint32_t, =0) \
     SINGLE(flags, uint16_t, =0) \
@@ -138,6 +223,10 @@ SINGLE(Animation, anim_type, uint8_t)
     SINGLE(secondary_reload, game_tick_t, =0) \
     SINGLE(ai_tick, game_tick_t, =0) \
     SINGLE(ai_shooting_tick, game_tick_t, =0) \
+    SINGLE(ai_ticks_since_think, game_tick_t, =0) \
+    SINGLE(ai_think_period, uint8_t, =1) \
+    SINGLE(ai_acceleration_step, Vector, .set(0,0)) \
+    SINGLE(ai_camera_distance, float, =0) \
     \
     SINGLE(poison_inflicted, float, =0) \
     SINGLE(poison_dealer, EntityID, =NULL_ENTITY) \
@@ -159,17 +248,15 @@ SINGLE(Animation, anim_type, uint8_t)
     SINGLE(ai_state, uint8_t, =0) \
     SINGLE(activated, uint8_t, =0) \
     SINGLE(pending_spawn_count, uint32_t, =0) \
+    ORBIT_EXTRA_FIELDS \
+    RECKONING_EXTRA_FIELDS \
     \
     SINGLE(zone, uint8_t, =0) \
     SINGLE(deletion_tick, uint8_t, =0) \
-    SINGLE(deleted_petals, deleted_petals_t, ={}) \
-    SINGLE(delayed_damage, delayed_damage_t, ={}) \
     SINGLE(client, Client *, =nullptr) \
     \
     SINGLE(chat_sent, EntityID, =NULL_ENTITY) \
-    SINGLE(chat_pos, uint8_t, =0) \
-    \
-    SINGLE(minimap_dots, std::set<EntityID>, ={})
+    SINGLE(chat_pos, uint8_t, =0)
 #else
 #define PER_EXTRA_FIELD \
     SINGLE(last_damaged_time, double, =0) \
@@ -182,7 +269,45 @@ SINGLE(Animation, anim_type, uint8_t)
     SINGLE(mouth, float, =15) \
     SINGLE(animation, float, =0) \
     SINGLE(damage_flash, float, =0) \
-    SINGLE(revival_burst, float, =0)
+    SINGLE(revival_burst, float, =0) \
+    ORBIT_EXTRA_FIELDS \
+    RECKONING_EXTRA_FIELDS
+#endif
+
+#ifdef ORBIT_PREDICTION
+#ifdef SERVERSIDE
+//where clients think the petal is, and whether this tick predicted and drove it
+#define ORBIT_EXTRA_FIELDS \
+    SINGLE(orbit_pos, Vector, .set(0,0)) \
+    SINGLE(orbit_stepped, uint8_t, =0) \
+    SINGLE(orbit_driven, uint8_t, =0)
+#else
+//the next tick's position, shown once its update arrives
+#define ORBIT_EXTRA_FIELDS \
+    SINGLE(predicted_x, float, =0) \
+    SINGLE(predicted_y, float, =0) \
+    SINGLE(predicted_angle, float, =0)
+#endif
+#else
+#define ORBIT_EXTRA_FIELDS
+#endif
+
+#ifdef DEAD_RECKONING
+#ifdef SERVERSIDE
+//where clients think the mob is, the acceleration it moved with last tick,
+//and whether some client was just sent the mob whole and needs it corrected
+#define RECKONING_EXTRA_FIELDS \
+    SINGLE(reckoned_pos, Vector, .set(0,0)) \
+    SINGLE(last_acceleration, Vector, .set(0,0)) \
+    SINGLE(reckoning_resync, uint8_t, =0)
+#else
+//the next tick's position, shown once its update arrives
+#define RECKONING_EXTRA_FIELDS \
+    SINGLE(reckoned_x, float, =0) \
+    SINGLE(reckoned_y, float, =0)
+#endif
+#else
+#define RECKONING_EXTRA_FIELDS
 #endif
 
 class EntityID {
@@ -223,4 +348,33 @@ public:
     PetalID::T get_petal_id() const;
     uint32_t size() const;
 };
+
+//what a flower's loadout adds up to, only recomputed once marked dirty
+//(a slot changed petal or first spawned), or the slot count or disabled state changed
+struct LoadoutSummary {
+    float vision_factor = 1;
+    float extra_range = 0;
+    float extra_damage = 0;
+    float damage_factor = 1;
+    float reload_factor = 1;
+    uint8_t yinyang_count = 0;
+    uint8_t equip_flags = 0;
+    //from slots that have spawned at least once
+    float extra_rot = 0;
+    float extra_health = 0;
+    float extra_radius = 0;
+    float health_factor = 1;
+    float speed_factor = 1;
+    float damage_reflection = 0;
+    float poison_armor = 0;
+    float heal = 0;
+    float defending_heal = 0;
+    uint8_t is_poisonous = 0;
+    //slots with petals that only do something while one of them is alive
+    uint16_t sponge_slots = 0;
+    uint16_t yggdrasil_slots = 0;
+    uint8_t loadout_count = 0;
+    uint8_t disabled = 0;
+    uint8_t dirty = 1;
+};
 #endif
\ No newline at end of file
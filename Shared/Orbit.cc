@@ -0,0 +1,43 @@
+#include <Shared/Orbit.hh>
+
+#include <Shared/Entity.hh>
+#include <Shared/StaticData.hh>
+
+#include <cmath>
+
+float const ORBIT_TOLERANCE = 2.0f;
+
+#ifdef ORBIT_PREDICTION
+//what the last update said, not what the client is drawing
+static float _sent(float v) { return v; }
+static float _sent(LerpFloat const &v) { return v.anchor(); }
+
+void orbit_predict(Entity const &flower, Entity const &petal, Vector &pos, Vector &vel, float &angle) {
+    struct PetalData const &petal_data = PETAL_DATA[petal.get_petal_id()];
+    Vector center(_sent(flower.get_x()), _sent(flower.get_y()));
+    //petal behavior runs before motion, so rotation sees last tick's position
+    if (petal_data.attributes.rotation_style == PetalAttributes::kPassiveRot) {
+        float rot_amt = petal.get_petal_id() == PetalID::kWing ? 10.0 : 1.0;
+        if (petal.id.id % 2) angle += rot_amt / TPS;
+        else angle -= rot_amt / TPS;
+    } else if (petal_data.attributes.rotation_style == PetalAttributes::kFollowRot)
+        angle = (pos - center).angle();
+
+    float range = flower.get_orbit_range();
+    if (petal_data.attributes.defend_only && BitMath::at(flower.get_face_flags(), FaceFlags::kAttacking))
+        range = _sent(flower.get_radius()) + 40;
+    Vector target;
+    target.unit_normal(petal.get_orbit_slot() + flower.get_orbit_heading());
+    target *= range;
+    if (petal_data.attributes.clump_radius > 0) {
+        Vector secondary;
+        secondary.unit_normal(2 * M_PI * petal.get_orbit_member() / petal_data.count + flower.get_orbit_heading() * 0.2)
+        .set_magnitude(petal_data.attributes.clump_radius);
+        target += secondary;
+    }
+    target += center;
+    vel *= (1 - PETAL_FRICTION);
+    vel += (target - pos) * 0.5;
+    pos += vel;
+}
+#endif
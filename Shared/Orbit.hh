@@ -0,0 +1,16 @@
+#pragma once
+
+#include <Helpers/Vector.hh>
+
+class Entity;
+
+//ORBIT_PREDICTION: clients move orbiting petals themselves from the orbit their flower
+//replicates, and the server keeps a copy of that prediction per petal, only sending a
+//petal's position once the real one strays more than ORBIT_TOLERANCE from it
+
+extern float const ORBIT_TOLERANCE;
+
+//one tick of an orbiting petal, as tick_player_behavior and tick_entity_motion would move it,
+//using only what flower and petal replicated last tick
+//pos and vel are the predicted state, angle follows the petal's rotation style
+void orbit_predict(Entity const &flower, Entity const &petal, Vector &pos, Vector &vel, float &angle);
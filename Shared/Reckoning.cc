@@ -0,0 +1,25 @@
+#include <Shared/Reckoning.hh>
+
+#include <Shared/Entity.hh>
+#include <Shared/StaticData.hh>
+
+#include <Helpers/Math.hh>
+
+float const RECKONING_TOLERANCE = 4.0f;
+float const RECKONING_STEER_TOLERANCE = 0.2f;
+
+#ifdef DEAD_RECKONING
+//what the last update said, not what the client is drawing
+static float _sent(float v) { return v; }
+static float _sent(LerpFloat const &v) { return v.anchor(); }
+
+void reckon_step(Entity const &mob, Vector &pos, Vector &vel, Vector &accel, Vector const &jerk) {
+    float const radius = _sent(mob.get_radius());
+    accel += jerk;
+    vel *= (1 - DEFAULT_FRICTION);
+    vel += accel;
+    pos += vel;
+    pos.x = fclamp(pos.x, radius, ARENA_WIDTH - radius);
+    pos.y = fclamp(pos.y, radius, ARENA_HEIGHT - radius);
+}
+#endif
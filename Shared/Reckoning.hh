@@ -0,0 +1,16 @@
+#pragma once
+
+#include <Helpers/Vector.hh>
+
+class Entity;
+
+//DEAD_RECKONING: clients carry mobs along their last replicated velocity, acceleration and
+//change in acceleration per tick, and the server keeps the same extrapolation per mob, only
+//sending a mob's motion again once it strays past RECKONING_TOLERANCE or its AI steers differently
+
+extern float const RECKONING_TOLERANCE;
+extern float const RECKONING_STEER_TOLERANCE;
+
+//one tick of a mob as tick_entity_motion would move it without collisions
+//pos, vel, accel and jerk are the extrapolated state
+void reckon_step(Entity const &mob, Vector &pos, Vector &vel, Vector &accel, Vector const &jerk);
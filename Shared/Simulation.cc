@@ -1,5 +1,9 @@
 #include <Shared/Simulation.hh>
 
+#ifdef SERVERSIDE
+#include <Server/Snapshot.hh>
+#endif
+
 #ifdef DEBUG
 #include <iostream>
 
@@ -8,7 +12,7 @@ std::ostream &operator<<(std::ostream &out, EntityID const &id) {
 }
 #endif
 
-Simulation::Simulation() SERVER_ONLY(: spatial_hash(this)) {
+Simulation::Simulation() SERVER_ONLY(: spatial_hash(this), threat_grid(this)) {
     reset();
 }
 
@@ -23,7 +27,13 @@ void Simulation::reset() {
     arena_info.init();
     #ifdef SERVERSIDE
     spatial_hash.refresh(ARENA_WIDTH, ARENA_HEIGHT);
+    threat_grid.clear();
+    leaderboard.clear();
     zone_mob_counts = {0};
+    for (std::atomic<uint32_t> &count : petal_counts)
+        count.store(0, std::memory_order_relaxed);
+    camera_count.store(0, std::memory_order_relaxed);
+    recovery_ids.clear();
     #endif
 }
 
@@ -104,4 +114,77 @@ void Simulation::for_each<k##name>(std::function<void(Simulation *, Entity &)> c
     } \
 }
 PERCOMPONENT
-#undef COMPONENT
\ No newline at end of file
+#undef COMPONENT
+
+#ifdef SERVERSIDE
+uint32_t Simulation::active_entity_count() const {
+    return active_entities.size();
+}
+
+void Simulation::for_each_in_range(uint8_t component, uint32_t begin, uint32_t end, void (*cb)(Simulation *, Entity &), uint8_t awake_only) {
+    DEBUG_ONLY(assert(begin <= end && end <= active_entities.size());)
+    for (uint32_t i = begin; i < end; ++i) {
+        if (!BitMath::at_arr(entity_tracker.data(), active_entities[i])) continue;
+        Entity &ent = entities[active_entities[i]];
+        if (awake_only && BitMath::at(ent.flags, EntityFlags::kIsDormant)) continue;
+        if (component == kComponentCount) cb(this, ent);
+        else if (!ent.pending_delete && ent.has_component(component)) cb(this, ent);
+    }
+}
+
+//the spatial hash is rebuilt every tick, so only the entities and counters go in
+void Simulation::save(Snapshot::Writer &writer) const {
+    writer.write<Rng>(rng);
+    writer.write(hash_tracker);
+    writer.write(zone_mob_counts);
+    for (std::atomic<uint32_t> const &count : petal_counts)
+        writer.write<uint32_t>(count.load(std::memory_order_relaxed));
+    uint32_t count = 0;
+    for (EntityID::id_type i = 1; i < ENTITY_CAP; ++i)
+        count += BitMath::at_arr(entity_tracker.data(), i);
+    writer.write<uint32_t>(count);
+    for (EntityID::id_type i = 1; i < ENTITY_CAP; ++i) {
+        if (!BitMath::at_arr(entity_tracker.data(), i)) continue;
+        writer.write<EntityID::id_type>(i);
+        entities[i].save(writer);
+    }
+}
+
+bool Simulation::load(Snapshot::Reader &reader) {
+    reset();
+    reader.read<Rng>(rng);
+    reader.read(hash_tracker);
+    reader.read(zone_mob_counts);
+    for (std::atomic<uint32_t> &count : petal_counts) {
+        uint32_t value = 0;
+        reader.read<uint32_t>(value);
+        count.store(value, std::memory_order_relaxed);
+    }
+    uint32_t count = 0;
+    reader.read<uint32_t>(count);
+    for (uint32_t n = 0; n < count && !reader.failed; ++n) {
+        EntityID::id_type i = 0;
+        reader.read<EntityID::id_type>(i);
+        if (i == 0 || i >= ENTITY_CAP || BitMath::at_arr(entity_tracker.data(), i)) {
+            reader.failed = true;
+            break;
+        }
+        BitMath::set_arr(entity_tracker.data(), i);
+        entities[i].load(reader);
+        entities[i].id = EntityID(i, hash_tracker[i]);
+        active_entities.push(i);
+    }
+    if (reader.failed) {
+        reset();
+        return false;
+    }
+    //derived state that alloc_camera and camera death normally keep in step
+    for (EntityID::id_type i : active_entities) {
+        Entity &ent = entities[i];
+        if (!ent.has_component(kCamera) || BitMath::at(ent.flags, EntityFlags::kCPUControlled)) continue;
+        camera_count.fetch_add(1, std::memory_order_relaxed);
+        if (!ent.pending_delete) recovery_ids[ent.get_recovery_id()] = ent.id;
+    }
+    return true;
+}
+#endif
\ No newline at end of file
@@ -4,11 +4,16 @@
 #include <Shared/Entity.hh>
 
 #ifdef SERVERSIDE
+#include <Server/Leaderboard.hh>
+#include <Server/Scheduler.hh>
 #include <Server/SpatialHash.hh>
+#include <Server/ThreatGrid.hh>
 #endif
 
+#include <atomic>
 #include <functional>
 #include <string>
+#include <unordered_map>
 
 inline uint32_t const ENTITY_CAP = 8192;
 
@@ -20,6 +25,16 @@ class Simulation {
 public:
     SERVER_ONLY(std::array<uint32_t, MAP_DATA.size()> zone_mob_counts;)
     SERVER_ONLY(SpatialHash spatial_hash;)
+    SERVER_ONLY(ThreatGrid threat_grid;)
+    SERVER_ONLY(Leaderboard leaderboard;)
+    SERVER_ONLY(Rng rng;)
+    //only written by the owning game, summed over games between ticks and by metrics
+    SERVER_ONLY(std::array<std::atomic<uint32_t>, PetalID::kNumPetals> petal_counts;)
+    SERVER_ONLY(std::atomic<uint32_t> camera_count;)
+    //filled by TICK_SCHEDULER, per game so concurrent games are not summed
+    SERVER_ONLY(SystemTimings system_timings;)
+    //recovery_id -> camera, kept in step with alloc_camera and camera death
+    SERVER_ONLY(std::unordered_map<uint64_t, EntityID> recovery_ids;)
     Arena arena_info;
     Simulation();
     void reset();
@@ -38,4 +53,12 @@ public:
     void for_each_entity(std::function<void (Simulation *, Entity &)>);
     template <uint8_t>
     void for_each(std::function<void (Simulation *, Entity &)>);
+    #ifdef SERVERSIDE
+    //for splitting a for_each over [0, active_entity_count()) between threads
+    //kComponentCount behaves like for_each_entity
+    uint32_t active_entity_count() const;
+    void save(Snapshot::Writer &) const;
+    bool load(Snapshot::Reader &);
+    void for_each_in_range(uint8_t, uint32_t, uint32_t, void (*)(Simulation *, Entity &), uint8_t = 0);
+    #endif
 };
\ No newline at end of file
@@ -5,6 +5,7 @@
 float const PETAL_DISABLE_DELAY = 45.0f; //seconds
 float const PLAYER_ACCELERATION = 5.0f;
 float const DEFAULT_FRICTION = 1.0f/3.0f;
+float const PETAL_FRICTION = DEFAULT_FRICTION * 1.5f;
 float const LIGHTNING_STRIKE_RADIUS = 300.0f;
 float const URANIUM_RADIATION_RADIUS = 1200.0f;
 float const DIGGER_SPAWN_CHANCE = 0.1f;
@@ -8,6 +8,7 @@
 extern float const PETAL_DISABLE_DELAY;
 extern float const PLAYER_ACCELERATION;
 extern float const DEFAULT_FRICTION;
+extern float const PETAL_FRICTION;
 extern float const LIGHTNING_STRIKE_RADIUS;
 extern float const URANIUM_RADIATION_RADIUS;
 extern float const DIGGER_SPAWN_CHANCE;
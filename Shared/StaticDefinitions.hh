@@ -196,7 +196,9 @@ namespace EntityFlags {
         kHasCulling,
         kIsCulled,
         kZombie,
-        kCPUControlled
+        kCPUControlled,
+        kIsDormant,
+        kThinkGranted
     };
 };
 
@@ -233,7 +235,8 @@ namespace InputFlags {
 namespace PetalFlags {
     enum {
         kLockedOn,
-        kSplitProjectile
+        kSplitProjectile,
+        kOrbiting
     };
 };
 
@@ -12,16 +12,22 @@ DEBUG=0
 WASM_SERVER=1
 GENERAL_SPATIAL_HASH=1
 USE_CODEPOINT_LEN=1
+#wire layout switches, client and server must be built with the same values
+ORBIT_PREDICTION=0
+DEAD_RECKONING=0
 WS_URL='wss://rysteria.pro/gardn/'
 VERSION_HASH=$(date +%s)
 SERVER_PORT=$(python3 -c 'import socket; s = socket.socket(); s.bind(("", 0)); print(s.getsockname()[1]); s.close()')
 JOBS=$(nproc)
 PID_FILE='gardn-server.pid'
+HANDOVER_FILE='gardn-handover.bin'
 NGINX_FILE="nginx/$VERSION_HASH.conf"
 
 cmake -S Client -B Client/build \
     "-DDEBUG=$DEBUG" \
     "-DUSE_CODEPOINT_LEN=$USE_CODEPOINT_LEN" \
+    "-DORBIT_PREDICTION=$ORBIT_PREDICTION" \
+    "-DDEAD_RECKONING=$DEAD_RECKONING" \
     "-DWS_URL=$WS_URL" \
     "-DVERSION_HASH=$VERSION_HASH"
 make -C Client/build "-j$JOBS"
@@ -31,12 +37,17 @@ cmake -S Server -B Server/build \
     "-DWASM_SERVER=$WASM_SERVER" \
     "-DGENERAL_SPATIAL_HASH=$GENERAL_SPATIAL_HASH" \
     "-DUSE_CODEPOINT_LEN=$USE_CODEPOINT_LEN" \
+    "-DORBIT_PREDICTION=$ORBIT_PREDICTION" \
+    "-DDEAD_RECKONING=$DEAD_RECKONING" \
     "-DVERSION_HASH=$VERSION_HASH" \
     "-DSERVER_PORT=$SERVER_PORT"
 make -C Server/build "-j$JOBS"
 
 cd Server/build
 
+#the draining server writes its sessions here and the new one takes them over
+export GARDN_HANDOVER="$PWD/$HANDOVER_FILE"
+
 if [[ "$WASM_SERVER" -eq 1 ]]; then
     node gardn-server.js &
 else